@@ -7,7 +7,9 @@
 
 #include "dwin.h"
 #include "dwin_itf.h"
+#include "dwin_trace.h"
 #include <stdlib.h>
+#include <string.h>
 
 /*
  * DWIN serial data write frame:
@@ -23,9 +25,6 @@
  *    Max length: (7 + 2n) bytes
  */
 
-#define DWIN_TX_TIMEOUT_TICKS 1000
-#define DWIN_RX_FRAME_TIMEOUT_TICKS 1000
-
 #define DWIN_COMM_FRAME_HEADER_HIGH 0x5a
 #define DWIN_COMM_FRAME_HEADER_LOW 0xa5
 
@@ -34,12 +33,50 @@
 #define DWIN_COMM_FRAME_CMD_WRITE_ACK_HIGH 0x4f
 #define DWIN_COMM_FRAME_CMD_WRITE_ACK_LOW 0x4b
 #define DWIN_VP_READ_TX_FRAME_LEN 7
+#define DWIN_WRITE_ACK_FRAME_LEN_FIELD 3
+#define DWIN_READ_RESPONSE_MIN_LEN_FIELD 4
 #if DWIN_VP_READ_TX_FRAME_LEN >= DWIN_TX_FRAME_MAX_LEN
 #error DWIN_TX_FRAME_MAX_LEN should be greater than DWIN_VP_READ_TX_FRAME_LEN
 #endif
 
 #define DWIN_UINT16_FROM_UINT8(high_byte, low_byte) ((uint16_t)((high_byte<<8)|low_byte))
 #define DWIN_VP_WRITE_TX_FRAME_LEN(data_len) ((data_len*2)+6)
+#define DWIN_VP_WRITE_ACK_FRAME_LEN 6
+#define DWIN_VP_READ_RESPONSE_FRAME_LEN(data_len) ((data_len*2)+7)
+/* start + 8 data + stop */
+#define DWIN_UART_BITS_PER_BYTE 10
+
+#if DWIN_USE_STATS
+#define DWIN_STATS_ADD(dwin, field, n) ((dwin)->stats.field += (n))
+#define DWIN_STATS_TX_START(dwin, ctick) \
+	((dwin)->stats_tx_timestamp = DWIN_STATS_TIMESTAMP(ctick))
+#define DWIN_STATS_ACK(dwin, ctick) dwin_stats_ack(dwin, DWIN_STATS_TIMESTAMP(ctick))
+#else
+#define DWIN_STATS_ADD(dwin, field, n) ((void)0)
+#define DWIN_STATS_TX_START(dwin, ctick) ((void)0)
+#define DWIN_STATS_ACK(dwin, ctick) ((void)(ctick))
+#endif
+#define DWIN_STATS_INC(dwin, field) DWIN_STATS_ADD(dwin, field, 1)
+
+#if DWIN_USE_WRITE_VERIFY
+#define DWIN_WRITE_VERIFY_CANCEL(dwin) ((dwin)->tx_verify_inflight = 0)
+#else
+#define DWIN_WRITE_VERIFY_CANCEL(dwin) ((void)0)
+#endif
+
+#if DWIN_USE_TRACE
+#define DWIN_TRACE_TX(dwin, len, ctick) \
+	(((dwin)->trace != NULL) ? dwin_trace_record((dwin)->trace, \
+			DWIN_TRACE_DIR_TX, (dwin)->tx_frame_ptr, (len), (ctick)) : (void)0)
+#define DWIN_TRACE_RX(dwin, data, ctick) \
+	(((dwin)->trace != NULL) ? dwin_trace_rx_byte((dwin)->trace, (data), (ctick)) : (void)0)
+#define DWIN_TRACE_RX_FLUSH(dwin) \
+	(((dwin)->trace != NULL) ? dwin_trace_rx_flush((dwin)->trace) : (void)0)
+#else
+#define DWIN_TRACE_TX(dwin, len, ctick) ((void)0)
+#define DWIN_TRACE_RX(dwin, data, ctick) ((void)0)
+#define DWIN_TRACE_RX_FLUSH(dwin) ((void)0)
+#endif
 
 enum dwin_frame_names {
 	DWIN_FRAME_NAME_HEADER_HIGH,
@@ -49,8 +86,235 @@ enum dwin_frame_names {
 	DWIN_FRAME_NAME_DATA_START,
 };
 
+static void dwin_ring_buffer_reset(dwin_t *dwin);
 static dwin_error_t dwin_ring_buffer_dequeue(dwin_t *dwin, uint8_t *data);
 
+#if DWIN_RX_FRAME_QUEUE_LEN
+#if (DWIN_RX_FRAME_QUEUE_LEN & (DWIN_RX_FRAME_QUEUE_LEN - 1)) != 0
+#error DWIN_RX_FRAME_QUEUE_LEN should be a power of 2
+#endif
+#if DWIN_RX_FRAME_QUEUE_LEN > 128
+#error DWIN_RX_FRAME_QUEUE_LEN should not exceed 128
+#endif
+#define DWIN_RX_FRAME_QUEUE_MASK (DWIN_RX_FRAME_QUEUE_LEN - 1)
+#endif
+
+#if DWIN_CB_EVENT_QUEUE_LEN
+#if (DWIN_CB_EVENT_QUEUE_LEN & (DWIN_CB_EVENT_QUEUE_LEN - 1)) != 0
+#error DWIN_CB_EVENT_QUEUE_LEN should be a power of 2
+#endif
+#if DWIN_CB_EVENT_QUEUE_LEN > 128
+#error DWIN_CB_EVENT_QUEUE_LEN should not exceed 128
+#endif
+#define DWIN_CB_EVENT_QUEUE_MASK (DWIN_CB_EVENT_QUEUE_LEN - 1)
+#endif
+
+#if DWIN_USE_STATS
+static void dwin_stats_ack(dwin_t *dwin, uint32_t timestamp) {
+	uint32_t latency = timestamp - dwin->stats_tx_timestamp;
+	uint8_t bucket = 0;
+
+	while ((latency != 0) && (bucket < (DWIN_STATS_LATENCY_BUCKETS - 1))) {
+		latency >>= 1;
+		++bucket;
+	}
+	++dwin->stats.ack_latency_hist[bucket];
+}
+#endif
+
+/* Ticks needed to shift len bytes out at the link baud rate, rounded up */
+static uint32_t dwin_wire_ticks(dwin_t *dwin, uint16_t len) {
+	uint32_t bits = (uint32_t) len * DWIN_UART_BITS_PER_BYTE;
+	return ((bits * DWIN_TICK_HZ) + dwin->link_baud - 1) / dwin->link_baud;
+}
+
+static uint32_t dwin_rto_ticks(dwin_t *dwin) {
+	uint32_t rto = DWIN_RTO_INITIAL_TICKS;
+
+	if (dwin->rtt_valid) {
+		rto = (dwin->rtt_srtt8 >> 3) + dwin->rtt_rttvar4;
+	}
+	if (rto < DWIN_RTO_MIN_TICKS) {
+		rto = DWIN_RTO_MIN_TICKS;
+	}
+	rto <<= dwin->rto_backoff;
+
+	return (rto < DWIN_RTO_MAX_TICKS) ? rto : DWIN_RTO_MAX_TICKS;
+}
+
+/*
+ * Feeds the estimator with the display turnaround of the request that just
+ * got its reply (RFC 6298, gains of 1/8 and 1/4).
+ */
+static void dwin_rtt_sample(dwin_t *dwin, uint32_t c_tick) {
+	uint32_t elapsed = c_tick - dwin->tx_last_sent_tick;
+	uint32_t sample =
+			(elapsed > dwin->tx_wire_ticks) ? (elapsed - dwin->tx_wire_ticks) : 0;
+
+	if (!dwin->rtt_valid) {
+		dwin->rtt_srtt8 = sample << 3;
+		dwin->rtt_rttvar4 = sample << 1;
+		dwin->rtt_valid = 1;
+	} else {
+		int32_t delta = (int32_t) sample - (int32_t) (dwin->rtt_srtt8 >> 3);
+		dwin->rtt_srtt8 += delta;
+		if (delta < 0) {
+			delta = -delta;
+		}
+		dwin->rtt_rttvar4 += delta - (int32_t) (dwin->rtt_rttvar4 >> 2);
+	}
+	dwin->rto_backoff = 0;
+}
+
+static uint8_t dwin_tx_frame_is_read(dwin_t *dwin) {
+	return (dwin->tx_frame_ptr[DWIN_FRAME_NAME_FUNC_CODE]
+			== DWIN_COMM_FRAME_CMD_READ_VARIABLE) ? 1 : 0;
+}
+
+/*
+ * Hands tx_frame_ptr to the UART and arms the request timeout. Used for
+ * the first transmission and for every retry, tx_frame_len and tx_wire_ticks
+ * have to be set by the caller.
+ */
+static dwin_error_t dwin_tx_send(dwin_t *dwin, uint32_t ctick) {
+	dwin_error_t ret_status = dwin_itf_uart_transmit_dma(dwin,
+			dwin->tx_frame_len);
+
+	if (ret_status == DWIN_ERROR_NOERR) {
+		DWIN_STATS_INC(dwin, tx_frames);
+		DWIN_STATS_ADD(dwin, tx_bytes, dwin->tx_frame_len);
+		DWIN_STATS_TX_START(dwin, ctick);
+		DWIN_TRACE_TX(dwin, dwin->tx_frame_len, ctick);
+		dwin->tx_last_sent_tick = ctick;
+		dwin->tx_timeout_ticks = dwin->tx_wire_ticks + dwin_rto_ticks(dwin);
+		dwin->tx_state =
+				dwin_tx_frame_is_read(dwin) ?
+						DWIN_TX_STATUS_TX_BUSY_READ_VP :
+						DWIN_TX_STATUS_TX_BUSY_WRITE_VP;
+	}
+	return ret_status;
+}
+
+/* Drops the frames of a batch that were ACKed before it is sent again */
+static void dwin_tx_skip_acked(dwin_t *dwin) {
+	if (dwin->tx_frame_acked == 0) {
+		return;
+	}
+
+	while (dwin->tx_frame_acked > 0) {
+		uint16_t frame_len = dwin->tx_frame_ptr[DWIN_FRAME_NAME_LEN] + 3;
+		dwin->tx_frame_ptr += frame_len;
+		dwin->tx_frame_len -= frame_len;
+		--dwin->tx_frame_count;
+		--dwin->tx_frame_acked;
+	}
+	dwin->tx_wire_ticks = dwin_wire_ticks(dwin,
+			dwin->tx_frame_len
+					+ (dwin->tx_write_ack ?
+							dwin->tx_frame_count * DWIN_VP_WRITE_ACK_FRAME_LEN :
+							0));
+}
+
+static void dwin_tx_timeout(dwin_t *dwin) {
+	DWIN_STATS_INC(dwin, tx_timeouts);
+	dwin_tx_skip_acked(dwin);
+	if (dwin->rto_backoff < DWIN_RTO_MAX_BACKOFF) {
+		++dwin->rto_backoff;
+	}
+
+	if (dwin->tx_retry_count < dwin->tx_retry_max) {
+		dwin->tx_state = DWIN_TX_STATUS_RETRY_PENDING;
+		return;
+	}
+
+	DWIN_STATS_INC(dwin, tx_failures);
+	++dwin->tx_fail_count;
+	dwin->tx_state = DWIN_TX_STATUS_IDLE;
+	DWIN_WRITE_VERIFY_CANCEL(dwin);
+	if (dwin->tx_fail_cb_fn != NULL) {
+		(*(dwin->tx_fail_cb_fn))(
+				DWIN_UINT16_FROM_UINT8(
+						dwin->tx_frame_ptr[DWIN_FRAME_NAME_DATA_START],
+						dwin->tx_frame_ptr[DWIN_FRAME_NAME_DATA_START + 1]),
+				dwin_tx_frame_is_read(dwin));
+	}
+}
+
+/*
+ * The request got its ACK / reply. Following Karn's algorithm, only replies
+ * to requests that were sent once are used as RTT samples. Batches are left
+ * out as well, their turnaround covers several frames.
+ */
+static void dwin_tx_reply(dwin_t *dwin, dwin_tx_state_t next_state,
+		uint32_t c_tick) {
+	if ((dwin->tx_retry_count == 0) && (dwin->tx_frame_count == 1)
+			&& (dwin->tx_state != DWIN_TX_STATUS_RETRY_PENDING)) {
+		DWIN_STATS_ACK(dwin, c_tick);
+		dwin_rtt_sample(dwin, c_tick);
+	}
+	dwin->tx_state = next_state;
+}
+
+#if DWIN_USE_WRITE_VERIFY
+/*
+ * Remembers a write sent without ACK when it is due for a read-back. Takes
+ * the frame itself, the TX complete ISR may already have moved tx_frame_ptr
+ * on to a chained batch.
+ */
+static void dwin_write_verify_track(dwin_t *dwin, const uint8_t *frame,
+		uint16_t frame_len) {
+	if (dwin->tx_write_ack || (dwin->tx_verify_interval == 0)) {
+		return;
+	}
+
+	uint16_t vp_start_addr = DWIN_UINT16_FROM_UINT8(
+			frame[DWIN_FRAME_NAME_DATA_START],
+			frame[DWIN_FRAME_NAME_DATA_START + 1]);
+	uint8_t vp_data_len = (frame_len - DWIN_VP_WRITE_TX_FRAME_LEN(0)) / 2;
+
+	/* a newer write to the VP waiting for its read-back replaces the expected data */
+	if ((--dwin->tx_verify_countdown == 0)
+			|| (dwin->tx_verify_pending
+					&& (dwin->tx_verify_addr == vp_start_addr))) {
+		if (dwin->tx_verify_countdown == 0) {
+			dwin->tx_verify_countdown = dwin->tx_verify_interval;
+		}
+		dwin->tx_verify_addr = vp_start_addr;
+		dwin->tx_verify_len =
+				(vp_data_len < DWIN_WRITE_VERIFY_MAX_LEN) ?
+						vp_data_len : DWIN_WRITE_VERIFY_MAX_LEN;
+		memcpy(dwin->tx_verify_data, &frame[DWIN_FRAME_NAME_DATA_START + 2],
+				2 * dwin->tx_verify_len);
+		dwin->tx_verify_pending = 1;
+	}
+}
+
+static void dwin_write_verify_process(dwin_t *dwin, uint32_t c_tick) {
+	if (dwin->tx_verify_pending && (dwin->tx_state == DWIN_TX_STATUS_IDLE)) {
+		if (dwin_read_vp(dwin, dwin->tx_verify_addr, dwin->tx_verify_len,
+				c_tick) == DWIN_ERROR_NOERR) {
+			DWIN_STATS_INC(dwin, write_verify_reads);
+			dwin->tx_verify_pending = 0;
+			dwin->tx_verify_inflight = 1;
+		}
+	}
+}
+
+/* The read-back of a write sent without ACK got its reply */
+static void dwin_write_verify_reply(dwin_t *dwin, uint8_t *data8_ptr) {
+	dwin->tx_verify_inflight = 0;
+
+	if (memcmp(data8_ptr, dwin->tx_verify_data, 2 * dwin->tx_verify_len)
+			!= 0) {
+		DWIN_STATS_INC(dwin, write_verify_failures);
+		++dwin->tx_fail_count;
+		if (dwin->tx_fail_cb_fn != NULL) {
+			(*(dwin->tx_fail_cb_fn))(dwin->tx_verify_addr, 0);
+		}
+	}
+}
+#endif
+
 dwin_error_t dwin_init(dwin_t *dwin, void *huart, uint8_t ring_buffer_size) {
 	dwin_error_t ret_status = DWIN_ERROR_NOERR;
 
@@ -58,25 +322,78 @@ dwin_error_t dwin_init(dwin_t *dwin, void *huart, uint8_t ring_buffer_size) {
 			|| (dwin->rx_ring_buffer.size >= DWIN_RX_CIRC_BUF_MAX_LEN)) {
 		return DWIN_ERROR_PARAM;
 	}
+#if DWIN_RX_RING_STATIC_LEN
+	if (ring_buffer_size > DWIN_RX_RING_STATIC_LEN) {
+		return DWIN_ERROR_PARAM;
+	}
+#endif
 
 	dwin->huart = huart;
 	dwin->rx_ring_buffer.size = ring_buffer_size;
 
 	dwin->tx_state = DWIN_TX_STATUS_IDLE;
-	dwin->tx_timeout_ticks = DWIN_TX_TIMEOUT_TICKS;
+	dwin->tx_frame_ptr = dwin->tx_frame_buffer;
+	dwin->tx_frame_count = 1;
+	dwin->tx_frame_acked = 0;
+#if DWIN_TX_BATCH_LEN
+	dwin->tx_batch_len = 0;
+	dwin->tx_batch_frames = 0;
+	dwin->tx_batch_fill = 0;
+	dwin->tx_batch_staging = 0;
+	dwin->tx_isr_chain = 0;
+#endif
+	dwin->rtt_valid = 0;
+	dwin->rto_backoff = 0;
+	dwin_set_link_baud(dwin, DWIN_LINK_BAUD_DEFAULT);
+	dwin->tx_retry_count = 0;
+	dwin->tx_retry_max = DWIN_TX_RETRY_MAX;
+	dwin->tx_fail_cb_fn = NULL;
+	dwin->tx_fail_count = 0;
+	dwin->tx_write_ack = 1;
+#if DWIN_USE_WRITE_VERIFY
+	dwin->tx_verify_interval = 0;
+	dwin->tx_verify_pending = 0;
+	dwin->tx_verify_inflight = 0;
+#endif
 
 	dwin->rx_state = DWIN_RX_STATUS_WAITING_HEADER;
-	dwin->rx_ring_buffer.head_index = -1;
-	dwin->rx_ring_buffer.tail_index = -1;
-	dwin->rx_frame_timeout_ticks = DWIN_RX_FRAME_TIMEOUT_TICKS;
+	dwin->rx_frame_len = 0;
+	dwin_ring_buffer_reset(dwin);
+#if DWIN_RX_FRAME_QUEUE_LEN
+	dwin->rx_frame_queue_head = 0;
+	dwin->rx_frame_queue_tail = 0;
+	dwin->upload_isr_cb_fn = NULL;
+#endif
 
-	for (uint8_t i = 0; i < DWIN_CALLBACK_ADDR_MAX_COUNT; ++i) {
+	for (uint16_t i = 0; i < DWIN_CALLBACK_ADDR_MAX_COUNT; ++i) {
 		dwin->cb_fn[i] = NULL;
+		dwin->cb_ctx_fn[i] = NULL;
+		dwin->cb_ctx[i] = NULL;
 		dwin->cb_address[i] = 0;
 	}
+	dwin->upload_cb_fn = NULL;
+#if DWIN_CB_EVENT_QUEUE_LEN
+	for (uint16_t i = 0; i < DWIN_CALLBACK_ADDR_MAX_COUNT; ++i) {
+		dwin->cb_deferred[i] = 0;
+	}
+	dwin->cb_event_queue_head = 0;
+	dwin->cb_event_queue_tail = 0;
+#endif
+
+#if DWIN_USE_STATS
+	dwin_stats_reset(dwin);
+#endif
+#if DWIN_USE_TRACE
+	dwin->trace = NULL;
+#endif
 
+#if DWIN_RX_RING_STATIC_LEN
+	memset(dwin->rx_ring_storage, 0, sizeof(dwin->rx_ring_storage));
+	dwin->rx_ring_buffer.buf_ptr = dwin->rx_ring_storage;
+#else
 	dwin->rx_ring_buffer.buf_ptr = (uint8_t*) calloc(dwin->rx_ring_buffer.size,
 			sizeof(uint8_t));
+#endif
 
 	if (dwin->rx_ring_buffer.buf_ptr != NULL) {
 		ret_status = dwin_itf_uart_receive_to_idle_dma(dwin);
@@ -92,6 +409,13 @@ dwin_error_t dwin_init(dwin_t *dwin, void *huart, uint8_t ring_buffer_size) {
 	return ret_status;
 }
 
+static void dwin_ring_buffer_reset(dwin_t *dwin) {
+	dwin->rx_ring_buffer.head_index = -1;
+	dwin->rx_ring_buffer.tail_index = -1;
+	dwin->rx_ring_buffer.write_count = 0;
+	dwin->rx_ring_buffer.read_count = 0;
+}
+
 static dwin_error_t dwin_ring_buffer_dequeue(dwin_t *dwin, uint8_t *data) {
 	if ((dwin == NULL) || (data == NULL)) {
 		return DWIN_ERROR_PARAM;
@@ -110,11 +434,13 @@ static dwin_error_t dwin_ring_buffer_dequeue(dwin_t *dwin, uint8_t *data) {
 			dwin->rx_ring_buffer.tail_index %= dwin->rx_ring_buffer.size;
 			*data =
 					dwin->rx_ring_buffer.buf_ptr[dwin->rx_ring_buffer.tail_index];
+			++dwin->rx_ring_buffer.read_count;
 		} else {
 			ret_status = DWIN_ERROR_QUEUE;
 		}
 	} else if (dwin->rx_ring_buffer.head_index >= 0) {
 		*data = dwin->rx_ring_buffer.buf_ptr[++dwin->rx_ring_buffer.tail_index];
+		++dwin->rx_ring_buffer.read_count;
 	} else {
 		ret_status = DWIN_ERROR_QUEUE;
 	}
@@ -122,230 +448,802 @@ static dwin_error_t dwin_ring_buffer_dequeue(dwin_t *dwin, uint8_t *data) {
 	return ret_status;
 }
 
-dwin_error_t dwin_process(dwin_t *dwin, uint32_t c_tick) {
-	if (dwin == NULL) {
-		return DWIN_ERROR_PARAM;
-	}
-
-	if (dwin->status == DWIN_STATUS_INIT) {
-		return DWIN_ERROR_ERR;
-	}
-
+/*
+ * Stores one byte in rx_frame_buffer and checks the frame against the command
+ * set as early as possible: the length has to fit rx_frame_buffer, only write
+ * ACKs (0x82, length 3) and read replies (0x83, length 4 + 2n) are accepted.
+ */
+static dwin_error_t dwin_rx_parse_byte(dwin_t *dwin, uint8_t rx_data,
+		uint32_t c_tick) {
 	dwin_error_t ret_status = DWIN_ERROR_NOERR;
-	uint8_t rx_data;
+	uint8_t *frame = dwin->rx_frame_buffer;
 
-	if (dwin->status == DWIN_STATUS_UART_ERROR) {
-		dwin->rx_state = DWIN_RX_STATUS_WAITING_HEADER;
-		dwin->tx_state = DWIN_TX_STATUS_IDLE;
-		dwin_itf_uart_abort(dwin);
-		dwin->rx_ring_buffer.head_index = -1;
-		dwin->rx_ring_buffer.tail_index = -1;
-		if (dwin_itf_uart_receive_to_idle_dma(dwin) == DWIN_ERROR_NOERR) {
-			dwin->status = DWIN_STATUS_OK;
-		}
-	}
+	dwin->rx_last_byte_tick = c_tick;
 
-	if (dwin->rx_state < DWIN_RX_STATUS_DATA_RECEIVED) {
-		if (dwin_ring_buffer_dequeue(dwin, &rx_data) == DWIN_ERROR_NOERR) {
-			switch (dwin->rx_state) {
-			case DWIN_RX_STATUS_WAITING_HEADER:
-				if (rx_data == DWIN_COMM_FRAME_HEADER_HIGH) {
-					dwin->rx_frame_buffer[DWIN_FRAME_NAME_HEADER_HIGH] =
-							rx_data;
-				} else if (rx_data == DWIN_COMM_FRAME_HEADER_LOW) {
-					dwin->rx_frame_buffer[DWIN_FRAME_NAME_HEADER_LOW] = rx_data;
-					if (dwin->rx_frame_buffer[DWIN_FRAME_NAME_HEADER_HIGH]
-							== DWIN_COMM_FRAME_HEADER_HIGH) {
-						dwin->rx_state = DWIN_RX_STATUS_WAITING_FRAME_LEN;
-						dwin->rx_frame_start_tick = c_tick;
-					}
-				}
-				break;
-			case DWIN_RX_STATUS_WAITING_FRAME_LEN:
-				dwin->rx_frame_buffer[DWIN_FRAME_NAME_LEN] = rx_data;
-				dwin->rx_state = DWIN_RX_STATUS_WAITING_FN_CODE;
-				break;
-			case DWIN_RX_STATUS_WAITING_FN_CODE:
-				dwin->rx_frame_buffer[DWIN_FRAME_NAME_FUNC_CODE] = rx_data;
-				dwin->rx_data_bytes_len =
-						dwin->rx_frame_buffer[DWIN_FRAME_NAME_LEN] - 1;
-				dwin->rx_num_data_bytes_received = 0;
-				dwin->rx_state = DWIN_RX_STATUS_WAITING_DATA;
-				break;
-			case DWIN_RX_STATUS_WAITING_DATA:
-				if (dwin->rx_num_data_bytes_received
-						< dwin->rx_data_bytes_len) {
-					dwin->rx_frame_buffer[DWIN_FRAME_NAME_DATA_START
-							+ dwin->rx_num_data_bytes_received] = rx_data;
-				}
-				if (++(dwin->rx_num_data_bytes_received)
-						== dwin->rx_data_bytes_len) {
-					dwin->rx_state = DWIN_RX_STATUS_DATA_RECEIVED;
-				}
-				break;
-			default:
-				break;
-			}
+	switch (dwin->rx_state) {
+	case DWIN_RX_STATUS_WAITING_HEADER:
+		if (rx_data == DWIN_COMM_FRAME_HEADER_HIGH) {
+			frame[DWIN_FRAME_NAME_HEADER_HIGH] = rx_data;
+			dwin->rx_frame_len = 1;
+			dwin->rx_state = DWIN_RX_STATUS_WAITING_HEADER_LOW;
+		} else {
+			DWIN_STATS_INC(dwin, dropped_bytes);
 		}
-	}
-
-	switch (dwin->tx_state) {
-	case DWIN_TX_STATUS_IDLE:
-	case DWIN_TX_STATUS_TX_BUSY_WRITE_VP:
-	case DWIN_TX_STATUS_TX_BUSY_READ_VP:
-		break;
-	case DWIN_TX_STATUS_VP_WRITE_TX_CMPLT:
-		dwin->tx_state = DWIN_TX_STATUS_VP_WRITE_ACK_WAITING;
 		break;
-	case DWIN_TX_STATUS_VP_READ_TX_CMPLT:
-		dwin->tx_state = DWIN_TX_STATUS_VP_READ_RESPONSE_WAITING;
+	case DWIN_RX_STATUS_WAITING_HEADER_LOW:
+		if (rx_data == DWIN_COMM_FRAME_HEADER_LOW) {
+			frame[DWIN_FRAME_NAME_HEADER_LOW] = rx_data;
+			dwin->rx_frame_len = 2;
+			dwin->rx_state = DWIN_RX_STATUS_WAITING_FRAME_LEN;
+		} else if (rx_data == DWIN_COMM_FRAME_HEADER_HIGH) {
+			DWIN_STATS_INC(dwin, dropped_bytes);
+		} else {
+			DWIN_STATS_ADD(dwin, dropped_bytes, 2);
+			dwin->rx_frame_len = 0;
+			dwin->rx_state = DWIN_RX_STATUS_WAITING_HEADER;
+		}
 		break;
-	case DWIN_TX_STATUS_VP_WRITE_ACK_WAITING:
+	case DWIN_RX_STATUS_WAITING_FRAME_LEN:
+		frame[dwin->rx_frame_len++] = rx_data;
+		if ((rx_data < DWIN_WRITE_ACK_FRAME_LEN_FIELD)
+				|| ((rx_data + DWIN_FRAME_NAME_FUNC_CODE)
+						> DWIN_RX_FRAME_MAX_LEN)) {
+			ret_status = DWIN_ERROR_ERR;
+		} else {
+			dwin->rx_state = DWIN_RX_STATUS_WAITING_FN_CODE;
+		}
 		break;
-	case DWIN_TX_STATUS_VP_READ_RESPONSE_WAITING:
+	case DWIN_RX_STATUS_WAITING_FN_CODE:
+		frame[dwin->rx_frame_len++] = rx_data;
+		if (((rx_data == DWIN_COMM_FRAME_CMD_WRITE_VARIABLE)
+				&& (frame[DWIN_FRAME_NAME_LEN] == DWIN_WRITE_ACK_FRAME_LEN_FIELD))
+				|| ((rx_data == DWIN_COMM_FRAME_CMD_READ_VARIABLE)
+						&& (frame[DWIN_FRAME_NAME_LEN]
+								>= DWIN_READ_RESPONSE_MIN_LEN_FIELD)
+						&& ((frame[DWIN_FRAME_NAME_LEN] & 0x01) == 0))) {
+			dwin->rx_data_bytes_len = frame[DWIN_FRAME_NAME_LEN] - 1;
+			dwin->rx_state = DWIN_RX_STATUS_WAITING_DATA;
+		} else {
+			ret_status = DWIN_ERROR_ERR;
+		}
 		break;
-	case DWIN_TX_STATUS_VP_WRITE_ACK:
-	case DWIN_TX_STATUS_VP_READ_RESPONSE:
-		dwin->tx_state = DWIN_TX_STATUS_IDLE;
+	case DWIN_RX_STATUS_WAITING_DATA:
+		frame[dwin->rx_frame_len++] = rx_data;
+		if ((frame[DWIN_FRAME_NAME_FUNC_CODE]
+				== DWIN_COMM_FRAME_CMD_READ_VARIABLE)
+				&& (dwin->rx_frame_len == (DWIN_FRAME_NAME_DATA_START + 3))
+				&& (frame[DWIN_FRAME_NAME_LEN]
+						!= (DWIN_READ_RESPONSE_MIN_LEN_FIELD + (2 * rx_data)))) {
+			ret_status = DWIN_ERROR_ERR;
+		} else if (dwin->rx_frame_len
+				== (DWIN_FRAME_NAME_DATA_START + dwin->rx_data_bytes_len)) {
+			dwin->rx_state = DWIN_RX_STATUS_DATA_RECEIVED;
+		}
 		break;
 	default:
 		break;
 	}
 
-	if (dwin->rx_state == DWIN_RX_STATUS_DATA_RECEIVED) {
-		dwin->rx_state = DWIN_RX_STATUS_WAITING_HEADER;
+	return ret_status;
+}
+
+/*
+ * A 0x83 frame is the reply to our pending read only if a read is in flight
+ * (or waiting for its retry) and the address and word count match the request. Anything else was pushed
+ * by the display on its own (touch key data auto-upload).
+ */
+static uint8_t dwin_rx_frame_is_read_response(dwin_t *dwin, uint16_t address,
+		uint8_t data_count) {
+	switch (dwin->tx_state) {
+	case DWIN_TX_STATUS_TX_BUSY_READ_VP:
+	case DWIN_TX_STATUS_VP_READ_TX_CMPLT:
+	case DWIN_TX_STATUS_VP_READ_RESPONSE_WAITING:
+	case DWIN_TX_STATUS_RETRY_PENDING:
+		return (dwin_tx_frame_is_read(dwin)
+				&& (address == dwin->tx_read_vp_addr)
+				&& (data_count == dwin->tx_read_vp_len)) ? 1 : 0;
+	default:
+		return 0;
+	}
+}
 
-		if (dwin->rx_frame_buffer[DWIN_FRAME_NAME_FUNC_CODE]
-				== DWIN_COMM_FRAME_CMD_READ_VARIABLE) {
+#if DWIN_CB_EVENT_QUEUE_LEN
+/* Producer side, only called from the dwin_process() context */
+static void dwin_cb_event_push(dwin_t *dwin, uint16_t cb_index,
+		const uint8_t *data8_ptr, uint8_t data16_count) {
+	uint8_t head = dwin->cb_event_queue_head;
 
-			if (dwin->tx_state == DWIN_TX_STATUS_VP_READ_RESPONSE_WAITING) {
-				dwin->tx_state = DWIN_TX_STATUS_VP_READ_RESPONSE;
-			}
+	if ((((head - dwin->cb_event_queue_tail) & 0xff)
+			>= DWIN_CB_EVENT_QUEUE_LEN)
+			|| ((2 * data16_count) > DWIN_CB_EVENT_DATA_MAX_LEN)) {
+		DWIN_STATS_INC(dwin, cb_event_drops);
+		return;
+	}
+
+	dwin->cb_event_queue[head & DWIN_CB_EVENT_QUEUE_MASK].cb_index = cb_index;
+	dwin->cb_event_queue[head & DWIN_CB_EVENT_QUEUE_MASK].data16_count =
+			data16_count;
+	memcpy(dwin->cb_event_slab[head & DWIN_CB_EVENT_QUEUE_MASK], data8_ptr,
+			2 * data16_count);
+	DWIN_COMPILER_BARRIER();
+	dwin->cb_event_queue_head = head + 1;
+}
+#endif
 
-			uint16_t address = DWIN_UINT16_FROM_UINT8(
-					dwin->rx_frame_buffer[DWIN_FRAME_NAME_DATA_START],
-					dwin->rx_frame_buffer[DWIN_FRAME_NAME_DATA_START + 1]);
+static void dwin_rx_frame_handle(dwin_t *dwin, uint8_t *frame,
+		uint32_t c_tick) {
+	DWIN_STATS_INC(dwin, rx_frames);
 
-			uint8_t data_count =
-					dwin->rx_frame_buffer[DWIN_FRAME_NAME_DATA_START + 2];
+	if (frame[DWIN_FRAME_NAME_FUNC_CODE]
+			== DWIN_COMM_FRAME_CMD_READ_VARIABLE) {
 
-			for (uint8_t i = 0; i < DWIN_CALLBACK_ADDR_MAX_COUNT; ++i) {
-				if (dwin->cb_fn[i] == NULL) {
-					break;
-				} else if (address == dwin->cb_address[i]) {
-					(*(dwin->cb_fn[i]))(
-							&(dwin->rx_frame_buffer[DWIN_FRAME_NAME_DATA_START
-									+ 3]), data_count);
+		uint16_t address = DWIN_UINT16_FROM_UINT8(
+				frame[DWIN_FRAME_NAME_DATA_START],
+				frame[DWIN_FRAME_NAME_DATA_START + 1]);
+
+		uint8_t data_count = frame[DWIN_FRAME_NAME_DATA_START + 2];
+		uint8_t *data_ptr = &(frame[DWIN_FRAME_NAME_DATA_START + 3]);
+
+		if (dwin_rx_frame_is_read_response(dwin, address, data_count)) {
+			dwin_tx_reply(dwin, DWIN_TX_STATUS_VP_READ_RESPONSE, c_tick);
+#if DWIN_USE_WRITE_VERIFY
+			if (dwin->tx_verify_inflight) {
+				dwin_write_verify_reply(dwin, data_ptr);
+				return;
+			}
+#endif
+		} else if ((dwin->upload_cb_fn != NULL)
+				&& (*(dwin->upload_cb_fn))(address, data_ptr, data_count)) {
+			return;
+		}
+
+		for (uint16_t i = 0; i < DWIN_CALLBACK_ADDR_MAX_COUNT; ++i) {
+			if ((dwin->cb_fn[i] == NULL) && (dwin->cb_ctx_fn[i] == NULL)) {
+				break;
+			} else if (address == dwin->cb_address[i]) {
+#if DWIN_CB_EVENT_QUEUE_LEN
+				if (dwin->cb_deferred[i]) {
+					dwin_cb_event_push(dwin, i, data_ptr, data_count);
 					break;
 				}
+#endif
+				if (dwin->cb_fn[i] != NULL) {
+					(*(dwin->cb_fn[i]))(data_ptr, data_count);
+				} else {
+					(*(dwin->cb_ctx_fn[i]))(dwin->cb_ctx[i], data_ptr,
+							data_count);
+				}
+				break;
 			}
-		} else if (dwin->tx_state == DWIN_TX_STATUS_VP_WRITE_ACK_WAITING) {
-			if (dwin->rx_frame_buffer[DWIN_FRAME_NAME_FUNC_CODE]
-					== DWIN_COMM_FRAME_CMD_WRITE_VARIABLE) {
-				if ((dwin->rx_frame_buffer[DWIN_FRAME_NAME_DATA_START]
-						== DWIN_COMM_FRAME_CMD_WRITE_ACK_HIGH)
-						&& (dwin->rx_frame_buffer[DWIN_FRAME_NAME_DATA_START + 1]
-								== DWIN_COMM_FRAME_CMD_WRITE_ACK_LOW)) {
-					dwin->tx_state = DWIN_TX_STATUS_VP_WRITE_ACK;
+		}
+	} else if ((dwin->tx_state == DWIN_TX_STATUS_VP_WRITE_TX_CMPLT)
+			|| (dwin->tx_state == DWIN_TX_STATUS_VP_WRITE_ACK_WAITING)
+			/* the first frames of a batch are ACKed while the rest is sent */
+			|| ((dwin->tx_state == DWIN_TX_STATUS_TX_BUSY_WRITE_VP)
+					&& (dwin->tx_frame_count > 1))
+			|| ((dwin->tx_state == DWIN_TX_STATUS_RETRY_PENDING)
+					&& !dwin_tx_frame_is_read(dwin))) {
+		if (frame[DWIN_FRAME_NAME_FUNC_CODE]
+				== DWIN_COMM_FRAME_CMD_WRITE_VARIABLE) {
+			if ((frame[DWIN_FRAME_NAME_DATA_START]
+					== DWIN_COMM_FRAME_CMD_WRITE_ACK_HIGH)
+					&& (frame[DWIN_FRAME_NAME_DATA_START + 1]
+							== DWIN_COMM_FRAME_CMD_WRITE_ACK_LOW)) {
+				/* ACKs come in frame order, the last one completes the request */
+				if (++dwin->tx_frame_acked >= dwin->tx_frame_count) {
+					dwin_tx_reply(dwin, DWIN_TX_STATUS_VP_WRITE_ACK, c_tick);
 				}
 			}
 		}
 	}
+}
 
-	if (dwin->tx_state != DWIN_TX_STATUS_IDLE) {
-		if ((c_tick - dwin->tx_last_sent_tick) >= dwin->tx_timeout_ticks) {
-			dwin->tx_state = DWIN_TX_STATUS_IDLE;
-		}
-	}
+#if DWIN_RX_FRAME_QUEUE_LEN
+/* Producer side, only called from the RX event ISR through dwin_rx_assemble() */
+static void dwin_rx_frame_push(dwin_t *dwin) {
+	uint8_t head = dwin->rx_frame_queue_head;
 
-	if (dwin->rx_state != DWIN_RX_STATUS_WAITING_HEADER) {
-		if ((c_tick - dwin->rx_frame_start_tick)
-				>= dwin->rx_frame_timeout_ticks) {
-			dwin->rx_state = DWIN_RX_STATUS_WAITING_HEADER;
-		}
+	if (((head - dwin->rx_frame_queue_tail) & 0xff)
+			>= DWIN_RX_FRAME_QUEUE_LEN) {
+		DWIN_STATS_INC(dwin, rx_frame_queue_drops);
+		return;
 	}
 
-	return ret_status;
+	dwin_rx_frame_t *slot = &dwin->rx_frame_queue[head
+			& DWIN_RX_FRAME_QUEUE_MASK];
+	slot->len = dwin->rx_frame_len;
+	memcpy(slot->data, dwin->rx_frame_buffer, dwin->rx_frame_len);
+	DWIN_COMPILER_BARRIER();
+	dwin->rx_frame_queue_head = head + 1;
 }
+#endif
 
-/*
- * DWIN serial data write frame:
- *  Request: 5aa5 07 82 1000 0064 0032
- *    Max length: (6 + 2n) bytes
- *  Response: 5aa5 03 82 4f4b
- *    Length: 6
- */
-dwin_error_t dwin_write_vp(dwin_t *dwin, uint16_t vp_start_addr,
-		uint16_t *vp_data_buff, uint8_t vp_data_len, uint32_t ctick) {
+#if DWIN_RX_FRAME_QUEUE_LEN
+/* Offers an unsolicited 0x83 frame to the ISR hook, returns 1 if it was consumed */
+static uint8_t dwin_rx_frame_upload_isr(dwin_t *dwin) {
+	uint8_t *frame = dwin->rx_frame_buffer;
 
-	if ((dwin == NULL) || (vp_data_buff == NULL) || (vp_data_len == 0)) {
-		return DWIN_ERROR_PARAM;
+	if ((dwin->upload_isr_cb_fn == NULL)
+			|| (frame[DWIN_FRAME_NAME_FUNC_CODE]
+					!= DWIN_COMM_FRAME_CMD_READ_VARIABLE)) {
+		return 0;
 	}
 
-	if (dwin->status == DWIN_STATUS_INIT) {
-		return DWIN_ERROR_ERR;
+	uint16_t address = DWIN_UINT16_FROM_UINT8(frame[DWIN_FRAME_NAME_DATA_START],
+			frame[DWIN_FRAME_NAME_DATA_START + 1]);
+	uint8_t data_count = frame[DWIN_FRAME_NAME_DATA_START + 2];
+
+	/* the reply to our read is left to dwin_process() */
+	if (dwin_rx_frame_is_read_response(dwin, address, data_count)
+			|| !(*(dwin->upload_isr_cb_fn))(address,
+					&frame[DWIN_FRAME_NAME_DATA_START + 3], data_count)) {
+		return 0;
 	}
-	if (dwin->tx_state != DWIN_TX_STATUS_IDLE) {
-		return DWIN_ERROR_BUSY;
+	DWIN_STATS_INC(dwin, rx_isr_uploads);
+	return 1;
+}
+#endif
+
+static void dwin_rx_frame_complete(dwin_t *dwin, uint32_t c_tick) {
+	dwin->rx_state = DWIN_RX_STATUS_WAITING_HEADER;
+#if DWIN_RX_FRAME_QUEUE_LEN
+	(void) c_tick;
+	if (!dwin_rx_frame_upload_isr(dwin)) {
+		dwin_rx_frame_push(dwin);
 	}
+#else
+	dwin_rx_frame_handle(dwin, dwin->rx_frame_buffer, c_tick);
+#endif
+	dwin->rx_frame_len = 0;
+}
 
-	dwin_error_t ret_status = DWIN_ERROR_NOERR;
-	uint16_t tx_frame_len = DWIN_VP_WRITE_TX_FRAME_LEN(vp_data_len);
+/*
+ * Gives up on the frame held in rx_frame_buffer and parses its bytes again,
+ * starting after its first byte. A false header, a corrupted length or a lost
+ * byte then only costs the bytes already received, and a real frame hidden
+ * behind them is still picked up.
+ */
+static void dwin_rx_resync(dwin_t *dwin, uint32_t c_tick) {
+	uint8_t *frame = dwin->rx_frame_buffer;
+	uint16_t len = dwin->rx_frame_len;
+	uint16_t skip = 1;
 
-	if (tx_frame_len >= DWIN_TX_FRAME_MAX_LEN) {
-		return DWIN_ERROR_ERR;
-	}
+	DWIN_STATS_INC(dwin, resyncs);
 
-	dwin->tx_frame_buffer[DWIN_FRAME_NAME_HEADER_HIGH] =
-	DWIN_COMM_FRAME_HEADER_HIGH;
-	dwin->tx_frame_buffer[DWIN_FRAME_NAME_HEADER_LOW] =
-	DWIN_COMM_FRAME_HEADER_LOW;
-	dwin->tx_frame_buffer[DWIN_FRAME_NAME_LEN] = tx_frame_len - 3;
-	dwin->tx_frame_buffer[DWIN_FRAME_NAME_FUNC_CODE] =
-	DWIN_COMM_FRAME_CMD_WRITE_VARIABLE;
-	dwin->tx_frame_buffer[DWIN_FRAME_NAME_DATA_START] = vp_start_addr >> 8;
-	dwin->tx_frame_buffer[DWIN_FRAME_NAME_DATA_START + 1] = vp_start_addr
-			& 0x00ff;
+	while (len != 0) {
+		uint16_t start = skip;
+		while ((start < len) && (frame[start] != DWIN_COMM_FRAME_HEADER_HIGH)) {
+			++start;
+		}
+		DWIN_STATS_ADD(dwin, dropped_bytes, start);
+		len -= start;
+		memmove(frame, &frame[start], len);
 
-	for (uint8_t i = 0; i < vp_data_len; ++i) {
-		dwin->tx_frame_buffer[DWIN_FRAME_NAME_DATA_START + 2 + (2 * i)] =
-				vp_data_buff[i] >> 8;
-		dwin->tx_frame_buffer[DWIN_FRAME_NAME_DATA_START + 2 + (2 * i) + 1] =
-				vp_data_buff[i] & 0x00ff;
-	}
+		dwin->rx_state = DWIN_RX_STATUS_WAITING_HEADER;
+		dwin->rx_frame_len = 0;
 
-	ret_status = dwin_itf_uart_transmit_dma(dwin, tx_frame_len);
-	if (ret_status == DWIN_ERROR_NOERR) {
-		dwin->tx_last_sent_tick = ctick;
-		dwin->tx_state = DWIN_TX_STATUS_TX_BUSY_WRITE_VP;
+		/* parsing writes each byte at or before its own position, so the rest stays intact */
+		uint16_t index = 0;
+		dwin_error_t parse_status = DWIN_ERROR_NOERR;
+		while ((index < len) && (parse_status == DWIN_ERROR_NOERR)
+				&& (dwin->rx_state != DWIN_RX_STATUS_DATA_RECEIVED)) {
+			parse_status = dwin_rx_parse_byte(dwin, frame[index++], c_tick);
+		}
+
+		uint16_t rest_len = len - index;
+		if (dwin->rx_state == DWIN_RX_STATUS_DATA_RECEIVED) {
+			dwin_rx_frame_complete(dwin, c_tick);
+			memmove(frame, &frame[index], rest_len);
+			len = rest_len;
+			skip = 0;
+		} else if (parse_status != DWIN_ERROR_NOERR) {
+			DWIN_STATS_INC(dwin, resyncs);
+			memmove(&frame[dwin->rx_frame_len], &frame[index], rest_len);
+			len = dwin->rx_frame_len + rest_len;
+			skip = 1;
+		} else {
+			break;
+		}
 	}
+}
 
-	return ret_status;
+static void dwin_rx_feed(dwin_t *dwin, uint8_t rx_data, uint32_t c_tick) {
+	if (dwin_rx_parse_byte(dwin, rx_data, c_tick) != DWIN_ERROR_NOERR) {
+		dwin_rx_resync(dwin, c_tick);
+	} else if (dwin->rx_state == DWIN_RX_STATUS_DATA_RECEIVED) {
+		dwin_rx_frame_complete(dwin, c_tick);
+	}
 }
 
 /*
- * DWIN serial data read frame:
- *  Request: 5A A5 04 83 1000 01
- *    Length: 7 bytes
- *  Response: 5A A5 06 83 1000 01 0002
- *    Max length: (7 + 2n) bytes
+ * The DMA keeps writing into the ring whether it was drained or not. Once
+ * more bytes are unread than the ring holds the oldest ones are overwritten:
+ * keep the newest size - 1 bytes (the most tail_index can tell apart from an
+ * empty ring), count the rest as lost and give up on the frame they cut
+ * through.
  */
-dwin_error_t dwin_read_vp(dwin_t *dwin, uint16_t vp_start_addr,
-		uint16_t vp_data_len, uint32_t ctick) {
+static void dwin_ring_buffer_check_overrun(dwin_t *dwin, uint32_t c_tick) {
+	dwin_ring_buffer_t *ring = &dwin->rx_ring_buffer;
+	uint32_t write_count;
+	int8_t head_index;
 
-	if ((dwin == NULL) || (vp_data_len == 0)) {
-		return DWIN_ERROR_PARAM;
+	/* both are updated by the RX event ISR, read them as a pair */
+	do {
+		write_count = ring->write_count;
+		DWIN_COMPILER_BARRIER();
+		head_index = ring->head_index;
+		DWIN_COMPILER_BARRIER();
+	} while (write_count != ring->write_count);
+
+	/* until the first byte is dequeued (tail_index -1) a full ring still reads fine */
+	uint32_t unread = write_count - ring->read_count;
+	if (unread <= (ring->tail_index < 0 ? ring->size : ring->size - 1U)) {
+		return;
 	}
 
-	if (dwin->status == DWIN_STATUS_INIT) {
+	uint32_t lost = unread - (ring->size - 1);
+	ring->read_count += lost;
+	ring->tail_index = (head_index + 1) % ring->size;
+	DWIN_STATS_INC(dwin, rx_overruns);
+	DWIN_STATS_ADD(dwin, rx_overrun_bytes, lost);
+
+	if (dwin->rx_state != DWIN_RX_STATUS_WAITING_HEADER) {
+		dwin_rx_resync(dwin, c_tick);
+	}
+}
+
+#if DWIN_RX_FRAME_QUEUE_LEN
+void dwin_rx_assemble(dwin_t *dwin) {
+	uint8_t rx_data;
+
+	/* dwin_process() owns the parser while it recovers from a UART error */
+	if (dwin->status != DWIN_STATUS_OK) {
+		return;
+	}
+
+	uint32_t c_tick = dwin_itf_get_tick();
+
+	/* a frame cut short is given up on once the next burst arrives */
+	if ((dwin->rx_state != DWIN_RX_STATUS_WAITING_HEADER)
+			&& ((c_tick - dwin->rx_last_byte_tick)
+					>= dwin->rx_frame_timeout_ticks)) {
+		DWIN_STATS_INC(dwin, rx_frame_timeouts);
+		dwin_rx_resync(dwin, c_tick);
+	}
+
+	dwin_ring_buffer_check_overrun(dwin, c_tick);
+	while (dwin_ring_buffer_dequeue(dwin, &rx_data) == DWIN_ERROR_NOERR) {
+		DWIN_STATS_INC(dwin, rx_bytes);
+		dwin_rx_feed(dwin, rx_data, c_tick);
+	}
+}
+
+/* Consumer side, hands at most DWIN_RX_FRAME_DISPATCH_MAX queued frames to the handlers */
+static void dwin_rx_frame_dispatch(dwin_t *dwin, uint32_t c_tick) {
+	for (uint8_t n = 0; n < DWIN_RX_FRAME_DISPATCH_MAX; ++n) {
+		uint8_t tail = dwin->rx_frame_queue_tail;
+
+		if (tail == dwin->rx_frame_queue_head) {
+			break;
+		}
+
+		DWIN_COMPILER_BARRIER();
+		dwin_rx_frame_t *slot = &dwin->rx_frame_queue[tail
+				& DWIN_RX_FRAME_QUEUE_MASK];
+#if DWIN_USE_TRACE
+		/* the trace only holds the frames, bytes dropped by the ISR are not seen here */
+		for (uint16_t i = 0; i < slot->len; ++i) {
+			DWIN_TRACE_RX(dwin, slot->data[i], c_tick);
+		}
+		DWIN_TRACE_RX_FLUSH(dwin);
+#endif
+		/* the slot is released after the handlers, they may keep using its data */
+		dwin_rx_frame_handle(dwin, slot->data, c_tick);
+		DWIN_COMPILER_BARRIER();
+		dwin->rx_frame_queue_tail = tail + 1;
+	}
+}
+#endif
+
+dwin_error_t dwin_process(dwin_t *dwin, uint32_t c_tick) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (dwin->status == DWIN_STATUS_INIT) {
 		return DWIN_ERROR_ERR;
 	}
-	if (dwin->tx_state != DWIN_TX_STATUS_IDLE) {
+
+	DWIN_PROF_BEGIN(DWIN_PROF_PROCESS);
+	dwin_error_t ret_status = DWIN_ERROR_NOERR;
+
+	if (dwin->status == DWIN_STATUS_UART_ERROR) {
+		DWIN_STATS_INC(dwin, uart_error_recoveries);
+		dwin->rx_state = DWIN_RX_STATUS_WAITING_HEADER;
+		dwin->rx_frame_len = 0;
+		dwin->tx_state = DWIN_TX_STATUS_IDLE;
+		DWIN_WRITE_VERIFY_CANCEL(dwin);
+		dwin_itf_uart_abort(dwin);
+		dwin_ring_buffer_reset(dwin);
+		if (dwin_itf_uart_receive_to_idle_dma(dwin) == DWIN_ERROR_NOERR) {
+			dwin->status = DWIN_STATUS_OK;
+		}
+	}
+
+#if DWIN_RX_FRAME_QUEUE_LEN
+	dwin_rx_frame_dispatch(dwin, c_tick);
+#else
+	uint8_t rx_data;
+
+	dwin_ring_buffer_check_overrun(dwin, c_tick);
+	while (dwin_ring_buffer_dequeue(dwin, &rx_data) == DWIN_ERROR_NOERR) {
+		DWIN_STATS_INC(dwin, rx_bytes);
+		DWIN_TRACE_RX(dwin, rx_data, c_tick);
+		dwin_rx_feed(dwin, rx_data, c_tick);
+	}
+	DWIN_TRACE_RX_FLUSH(dwin);
+#endif
+
+	switch (dwin->tx_state) {
+	case DWIN_TX_STATUS_IDLE:
+	case DWIN_TX_STATUS_TX_BUSY_WRITE_VP:
+	case DWIN_TX_STATUS_TX_BUSY_READ_VP:
+		break;
+	case DWIN_TX_STATUS_VP_WRITE_TX_CMPLT:
+		dwin->tx_state = DWIN_TX_STATUS_VP_WRITE_ACK_WAITING;
+		break;
+	case DWIN_TX_STATUS_VP_READ_TX_CMPLT:
+		dwin->tx_state = DWIN_TX_STATUS_VP_READ_RESPONSE_WAITING;
+		break;
+	case DWIN_TX_STATUS_VP_WRITE_ACK_WAITING:
+		break;
+	case DWIN_TX_STATUS_VP_READ_RESPONSE_WAITING:
+		break;
+	case DWIN_TX_STATUS_VP_WRITE_ACK:
+	case DWIN_TX_STATUS_VP_READ_RESPONSE:
+		dwin->tx_state = DWIN_TX_STATUS_IDLE;
+		break;
+	case DWIN_TX_STATUS_RETRY_PENDING:
+		dwin_tx_skip_acked(dwin);
+		if (dwin_tx_send(dwin, c_tick) == DWIN_ERROR_NOERR) {
+			++dwin->tx_retry_count;
+			DWIN_STATS_INC(dwin, tx_retries);
+		}
+		break;
+	default:
+		break;
+	}
+
+	if ((dwin->tx_state != DWIN_TX_STATUS_IDLE)
+			&& (dwin->tx_state != DWIN_TX_STATUS_RETRY_PENDING)) {
+		/* a batch started by the TX complete ISR may be newer than c_tick */
+		int32_t elapsed = (int32_t) (c_tick - dwin->tx_last_sent_tick);
+		if ((elapsed >= 0)
+				&& ((uint32_t) elapsed >= dwin->tx_timeout_ticks)) {
+			dwin_tx_timeout(dwin);
+		}
+	}
+
+#if DWIN_TX_BATCH_LEN
+	if (dwin->tx_state == DWIN_TX_STATUS_IDLE) {
+		dwin_batch_flush(dwin, c_tick);
+	}
+#endif
+#if DWIN_USE_WRITE_VERIFY
+	dwin_write_verify_process(dwin, c_tick);
+#endif
+
+#if !DWIN_RX_FRAME_QUEUE_LEN
+	if (dwin->rx_state != DWIN_RX_STATUS_WAITING_HEADER) {
+		if ((c_tick - dwin->rx_last_byte_tick)
+				>= dwin->rx_frame_timeout_ticks) {
+			DWIN_STATS_INC(dwin, rx_frame_timeouts);
+			dwin_rx_resync(dwin, c_tick);
+		}
+	}
+#endif
+
+	DWIN_PROF_END(DWIN_PROF_PROCESS);
+	return ret_status;
+}
+
+/*
+ * Takes the transmitter for a new request. A write may also replace a timed
+ * out single write that is waiting for its retry when it starts at the same
+ * VP and covers at least as many words, so no tail of the old write is lost.
+ */
+static dwin_error_t dwin_tx_claim(dwin_t *dwin, uint8_t is_read,
+		uint16_t vp_start_addr, uint16_t frame_len) {
+	if (!is_read && (dwin->tx_state == DWIN_TX_STATUS_RETRY_PENDING)
+			&& (dwin->tx_frame_count == 1) && !dwin_tx_frame_is_read(dwin)
+			&& (DWIN_UINT16_FROM_UINT8(
+					dwin->tx_frame_ptr[DWIN_FRAME_NAME_DATA_START],
+					dwin->tx_frame_ptr[DWIN_FRAME_NAME_DATA_START + 1])
+					== vp_start_addr) && (frame_len >= dwin->tx_frame_len)) {
+		/* newer data for the VP whose write timed out, send it instead of the retry */
+		DWIN_STATS_INC(dwin, tx_superseded);
+	} else if (dwin->tx_state != DWIN_TX_STATUS_IDLE) {
+		DWIN_STATS_INC(dwin, busy_rejections);
 		return DWIN_ERROR_BUSY;
 	}
+	return DWIN_ERROR_NOERR;
+}
+
+/* Sends a complete write / read frame, built in tx_frame_buffer or constant */
+static dwin_error_t dwin_tx_start(dwin_t *dwin, const uint8_t *frame,
+		uint16_t frame_len, uint32_t ctick) {
+	dwin->tx_frame_ptr = frame;
+	dwin->tx_frame_len = frame_len;
+	dwin->tx_frame_count = 1;
+	dwin->tx_frame_acked = 0;
+	dwin->tx_retry_count = 0;
+
+	if (dwin_tx_frame_is_read(dwin)) {
+		dwin->tx_read_vp_addr = DWIN_UINT16_FROM_UINT8(
+				frame[DWIN_FRAME_NAME_DATA_START],
+				frame[DWIN_FRAME_NAME_DATA_START + 1]);
+		dwin->tx_read_vp_len = frame[DWIN_FRAME_NAME_DATA_START + 2];
+		dwin->tx_wire_ticks = dwin_wire_ticks(dwin,
+				frame_len
+						+ DWIN_VP_READ_RESPONSE_FRAME_LEN(
+								dwin->tx_read_vp_len));
+		return dwin_tx_send(dwin, ctick);
+	}
+
+	dwin->tx_wire_ticks = dwin_wire_ticks(dwin,
+			frame_len + (dwin->tx_write_ack ? DWIN_VP_WRITE_ACK_FRAME_LEN : 0));
+
+	dwin_error_t ret_status = dwin_tx_send(dwin, ctick);
+
+#if DWIN_USE_WRITE_VERIFY
+	if (ret_status == DWIN_ERROR_NOERR) {
+		dwin_write_verify_track(dwin, frame, frame_len);
+	}
+#endif
+
+	return ret_status;
+}
+
+/* Swaps the bytes of both halfwords, a single REV16 on ARMv6 and later */
+static inline uint32_t dwin_rev16(uint32_t value) {
+#if defined(__arm__) && defined(__ARM_ARCH) && (__ARM_ARCH >= 6)
+	uint32_t result;
+	__asm__ ("rev16 %0, %1" : "=r" (result) : "r" (value));
+	return result;
+#else
+	return ((value & 0x00ff00ffUL) << 8) | ((value >> 8) & 0x00ff00ffUL);
+#endif
+}
+
+/*
+ * Copies count native uint16_t words to dst in big endian (panel) byte order,
+ * two words at a time. dst and src do not need to be 32 bit aligned.
+ */
+static void dwin_swap16_copy(uint8_t *dst, const uint16_t *src, uint8_t count) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	memcpy(dst, src, 2 * count);
+#else
+	size_t i = 0;
+
+	for (; (i + 1) < count; i += 2) {
+		uint32_t pair;
+		memcpy(&pair, &src[i], sizeof(pair));
+		pair = dwin_rev16(pair);
+		memcpy(&dst[2 * i], &pair, sizeof(pair));
+	}
+	if (i < count) {
+		dst[2 * i] = src[i] >> 8;
+		dst[(2 * i) + 1] = src[i] & 0x00ff;
+	}
+#endif
+}
+
+static void dwin_write_vp_header(uint8_t *frame, uint16_t vp_start_addr,
+		uint16_t tx_frame_len) {
+	frame[DWIN_FRAME_NAME_HEADER_HIGH] = DWIN_COMM_FRAME_HEADER_HIGH;
+	frame[DWIN_FRAME_NAME_HEADER_LOW] = DWIN_COMM_FRAME_HEADER_LOW;
+	frame[DWIN_FRAME_NAME_LEN] = tx_frame_len - 3;
+	frame[DWIN_FRAME_NAME_FUNC_CODE] = DWIN_COMM_FRAME_CMD_WRITE_VARIABLE;
+	frame[DWIN_FRAME_NAME_DATA_START] = vp_start_addr >> 8;
+	frame[DWIN_FRAME_NAME_DATA_START + 1] = vp_start_addr & 0x00ff;
+}
+
+/*
+ * DWIN serial data write frame:
+ *  Request: 5aa5 07 82 1000 0064 0032
+ *    Max length: (6 + 2n) bytes
+ *  Response: 5aa5 03 82 4f4b
+ *    Length: 6
+ */
+dwin_error_t dwin_write_vp(dwin_t *dwin, uint16_t vp_start_addr,
+		uint16_t *vp_data_buff, uint8_t vp_data_len, uint32_t ctick) {
+
+	if ((dwin == NULL) || (vp_data_buff == NULL) || (vp_data_len == 0)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (dwin->status == DWIN_STATUS_INIT) {
+		return DWIN_ERROR_ERR;
+	}
+	if (vp_data_len > DWIN_VP_WRITE_MAX_DATA_LEN) {
+		return DWIN_ERROR_ERR;
+	}
+	uint16_t tx_frame_len = DWIN_VP_WRITE_TX_FRAME_LEN(vp_data_len);
+
+	if (dwin_tx_claim(dwin, 0, vp_start_addr, tx_frame_len)
+			!= DWIN_ERROR_NOERR) {
+		return DWIN_ERROR_BUSY;
+	}
+
+	DWIN_PROF_BEGIN(DWIN_PROF_WRITE_VP_BUILD);
+	dwin_write_vp_header(dwin->tx_frame_buffer, vp_start_addr, tx_frame_len);
+	dwin_swap16_copy(&dwin->tx_frame_buffer[DWIN_FRAME_NAME_DATA_START + 2],
+			vp_data_buff, vp_data_len);
+	DWIN_PROF_END(DWIN_PROF_WRITE_VP_BUILD);
+
+	return dwin_tx_start(dwin, dwin->tx_frame_buffer, tx_frame_len, ctick);
+}
+
+dwin_error_t dwin_write_vp_raw(dwin_t *dwin, uint16_t vp_start_addr,
+		const uint8_t *vp_data_be, uint8_t vp_data_len, uint32_t ctick) {
+
+	if ((dwin == NULL) || (vp_data_be == NULL) || (vp_data_len == 0)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (dwin->status == DWIN_STATUS_INIT) {
+		return DWIN_ERROR_ERR;
+	}
+	if (vp_data_len > DWIN_VP_WRITE_MAX_DATA_LEN) {
+		return DWIN_ERROR_ERR;
+	}
+	uint16_t tx_frame_len = DWIN_VP_WRITE_TX_FRAME_LEN(vp_data_len);
+
+	if (dwin_tx_claim(dwin, 0, vp_start_addr, tx_frame_len)
+			!= DWIN_ERROR_NOERR) {
+		return DWIN_ERROR_BUSY;
+	}
+
+	DWIN_PROF_BEGIN(DWIN_PROF_WRITE_VP_BUILD);
+	dwin_write_vp_header(dwin->tx_frame_buffer, vp_start_addr, tx_frame_len);
+	memcpy(&dwin->tx_frame_buffer[DWIN_FRAME_NAME_DATA_START + 2], vp_data_be,
+			2 * vp_data_len);
+	DWIN_PROF_END(DWIN_PROF_WRITE_VP_BUILD);
+
+	return dwin_tx_start(dwin, dwin->tx_frame_buffer, tx_frame_len, ctick);
+}
+
+#if DWIN_TX_BATCH_LEN
+dwin_error_t dwin_batch_write_vp(dwin_t *dwin, uint16_t vp_start_addr,
+		uint16_t *vp_data_buff, uint8_t vp_data_len) {
+
+	if ((dwin == NULL) || (vp_data_buff == NULL) || (vp_data_len == 0)
+			|| (vp_data_len > DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	uint16_t tx_frame_len = DWIN_VP_WRITE_TX_FRAME_LEN(vp_data_len);
+
+	/* keeps the TX complete ISR from flipping the buffers meanwhile */
+	dwin->tx_batch_staging = 1;
+	DWIN_COMPILER_BARRIER();
 
 	dwin_error_t ret_status = DWIN_ERROR_NOERR;
 
+	if (((dwin->tx_batch_len + tx_frame_len) > DWIN_TX_BATCH_LEN)
+			|| (dwin->tx_batch_frames == UINT8_MAX)) {
+		ret_status = DWIN_ERROR_QUEUE;
+	} else {
+		uint8_t *frame =
+				&dwin->tx_batch_buffer[dwin->tx_batch_fill][dwin->tx_batch_len];
+		dwin_write_vp_header(frame, vp_start_addr, tx_frame_len);
+		dwin_swap16_copy(&frame[DWIN_FRAME_NAME_DATA_START + 2], vp_data_buff,
+				vp_data_len);
+
+		dwin->tx_batch_len += tx_frame_len;
+		++dwin->tx_batch_frames;
+	}
+
+	DWIN_COMPILER_BARRIER();
+	dwin->tx_batch_staging = 0;
+	return ret_status;
+}
+
+dwin_error_t dwin_batch_flush(dwin_t *dwin, uint32_t ctick) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (dwin->status == DWIN_STATUS_INIT) {
+		return DWIN_ERROR_ERR;
+	}
+	if (dwin->tx_batch_frames == 0) {
+		return DWIN_ERROR_NOERR;
+	}
+	if (dwin->tx_state != DWIN_TX_STATUS_IDLE) {
+		return DWIN_ERROR_BUSY;
+	}
+
+	dwin->tx_frame_ptr = dwin->tx_batch_buffer[dwin->tx_batch_fill];
+	dwin->tx_frame_len = dwin->tx_batch_len;
+	dwin->tx_frame_count = dwin->tx_batch_frames;
+	dwin->tx_frame_acked = 0;
+	dwin->tx_retry_count = 0;
+	dwin->tx_wire_ticks = dwin_wire_ticks(dwin,
+			dwin->tx_frame_len
+					+ (dwin->tx_write_ack ?
+							dwin->tx_frame_count * DWIN_VP_WRITE_ACK_FRAME_LEN :
+							0));
+
+	dwin_error_t ret_status = dwin_tx_send(dwin, ctick);
+
+	if (ret_status == DWIN_ERROR_NOERR) {
+		DWIN_STATS_INC(dwin, tx_batches);
+		DWIN_STATS_ADD(dwin, tx_batch_frames, dwin->tx_frame_count);
+		/* the sent buffer stays untouched until the batch completes */
+		dwin->tx_batch_fill ^= 1;
+		dwin->tx_batch_len = 0;
+		dwin->tx_batch_frames = 0;
+	}
+	return ret_status;
+}
+
+dwin_error_t dwin_set_tx_isr_chain(dwin_t *dwin, uint8_t enabled) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin->tx_isr_chain = enabled ? 1 : 0;
+	return DWIN_ERROR_NOERR;
+}
+
+/*
+ * Called from the TX complete ISR once a write without ACK is done. The main
+ * loop only touches the staging buffers with tx_batch_staging set, and sends
+ * from them only while the link is idle, i.e. while no TX interrupt can come.
+ * The trace buffer is written from the main loop only, so a traced link is
+ * not chained.
+ */
+static void dwin_batch_chain(dwin_t *dwin) {
+	if (!dwin->tx_isr_chain || dwin->tx_batch_staging
+			|| (dwin->tx_batch_frames == 0)
+			|| (dwin->status != DWIN_STATUS_OK)) {
+		return;
+	}
+#if DWIN_USE_TRACE
+	if (dwin->trace != NULL) {
+		return;
+	}
+#endif
+
+	if (dwin_batch_flush(dwin, dwin_itf_get_tick()) == DWIN_ERROR_NOERR) {
+		DWIN_STATS_INC(dwin, tx_isr_chained);
+	}
+}
+#endif
+
+/*
+ * DWIN serial data read frame:
+ *  Request: 5A A5 04 83 1000 01
+ *    Length: 7 bytes
+ *  Response: 5A A5 06 83 1000 01 0002
+ *    Max length: (7 + 2n) bytes
+ */
+dwin_error_t dwin_read_vp(dwin_t *dwin, uint16_t vp_start_addr,
+		uint16_t vp_data_len, uint32_t ctick) {
+
+	if ((dwin == NULL) || (vp_data_len == 0)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (dwin->status == DWIN_STATUS_INIT) {
+		return DWIN_ERROR_ERR;
+	}
+	if (dwin_tx_claim(dwin, 1, vp_start_addr, DWIN_VP_READ_TX_FRAME_LEN)
+			!= DWIN_ERROR_NOERR) {
+		return DWIN_ERROR_BUSY;
+	}
+
 	dwin->tx_frame_buffer[DWIN_FRAME_NAME_HEADER_HIGH] =
 	DWIN_COMM_FRAME_HEADER_HIGH;
 	dwin->tx_frame_buffer[DWIN_FRAME_NAME_HEADER_LOW] =
@@ -358,53 +1256,345 @@ dwin_error_t dwin_read_vp(dwin_t *dwin, uint16_t vp_start_addr,
 			& 0x00ff;
 	dwin->tx_frame_buffer[DWIN_FRAME_NAME_DATA_START + 2] = vp_data_len;
 
-	ret_status = dwin_itf_uart_transmit_dma(dwin, DWIN_VP_READ_TX_FRAME_LEN);
-	if (ret_status == DWIN_ERROR_NOERR) {
-		dwin->tx_last_sent_tick = ctick;
-		dwin->tx_state = DWIN_TX_STATUS_TX_BUSY_READ_VP;
+	return dwin_tx_start(dwin, dwin->tx_frame_buffer,
+			DWIN_VP_READ_TX_FRAME_LEN, ctick);
+}
+
+dwin_error_t dwin_send_frame(dwin_t *dwin, const uint8_t *frame,
+		uint16_t frame_len, uint32_t ctick) {
+	if ((dwin == NULL) || (frame == NULL)
+			|| (frame_len < DWIN_VP_READ_TX_FRAME_LEN)
+			|| (frame[DWIN_FRAME_NAME_HEADER_HIGH]
+					!= DWIN_COMM_FRAME_HEADER_HIGH)
+			|| (frame[DWIN_FRAME_NAME_HEADER_LOW] != DWIN_COMM_FRAME_HEADER_LOW)
+			|| (frame[DWIN_FRAME_NAME_LEN] != frame_len - 3)) {
+		return DWIN_ERROR_PARAM;
 	}
 
-	return ret_status;
+	uint8_t is_read = 0;
+	switch (frame[DWIN_FRAME_NAME_FUNC_CODE]) {
+	case DWIN_COMM_FRAME_CMD_READ_VARIABLE:
+		if ((frame_len != DWIN_VP_READ_TX_FRAME_LEN)
+				|| (frame[DWIN_FRAME_NAME_DATA_START + 2] == 0)) {
+			return DWIN_ERROR_PARAM;
+		}
+		is_read = 1;
+		break;
+	case DWIN_COMM_FRAME_CMD_WRITE_VARIABLE:
+		if ((frame_len < DWIN_VP_WRITE_TX_FRAME_LEN(1)) || (frame_len & 1)) {
+			return DWIN_ERROR_PARAM;
+		}
+		break;
+	default:
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (dwin->status == DWIN_STATUS_INIT) {
+		return DWIN_ERROR_ERR;
+	}
+	if (dwin_tx_claim(dwin, is_read,
+			DWIN_UINT16_FROM_UINT8(frame[DWIN_FRAME_NAME_DATA_START],
+					frame[DWIN_FRAME_NAME_DATA_START + 1]), frame_len)
+			!= DWIN_ERROR_NOERR) {
+		return DWIN_ERROR_BUSY;
+	}
+
+	return dwin_tx_start(dwin, frame, frame_len, ctick);
 }
 
-dwin_error_t dwin_reg_cb(dwin_t *dwin, uint16_t watch_address,
-		dwin_event_cb_fn_t cb_fn) {
+dwin_error_t dwin_set_link_baud(dwin_t *dwin, uint32_t baud) {
+	if ((dwin == NULL) || (baud == 0)) {
+		return DWIN_ERROR_PARAM;
+	}
 
-	if ((dwin == NULL) || (cb_fn == NULL)) {
+	dwin->link_baud = baud;
+	dwin->rx_frame_timeout_ticks = DWIN_RX_FRAME_GAP_TICKS
+			+ dwin_wire_ticks(dwin, DWIN_RX_FRAME_MAX_LEN);
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_set_tx_retry_max(dwin_t *dwin, uint8_t retry_max) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin->tx_retry_max = retry_max;
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_reg_tx_fail_cb(dwin_t *dwin, dwin_tx_fail_cb_fn_t cb_fn) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin->tx_fail_cb_fn = cb_fn;
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_set_write_ack(dwin_t *dwin, uint8_t ack_enabled) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin->tx_write_ack = ack_enabled ? 1 : 0;
+	return DWIN_ERROR_NOERR;
+}
+
+#if DWIN_USE_WRITE_VERIFY
+dwin_error_t dwin_set_write_verify_interval(dwin_t *dwin, uint8_t interval) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin->tx_verify_interval = interval;
+	dwin->tx_verify_countdown = interval;
+	dwin->tx_verify_pending = 0;
+	return DWIN_ERROR_NOERR;
+}
+#endif
+
+dwin_error_t dwin_uart_set_baud(dwin_t *dwin, uint32_t baud) {
+	if ((dwin == NULL) || (baud == 0)) {
 		return DWIN_ERROR_PARAM;
 	}
 
+	if (dwin->status == DWIN_STATUS_INIT) {
+		return DWIN_ERROR_ERR;
+	}
+	if (dwin->tx_state != DWIN_TX_STATUS_IDLE) {
+		return DWIN_ERROR_BUSY;
+	}
+
+	dwin_itf_uart_abort(dwin);
+	dwin->rx_state = DWIN_RX_STATUS_WAITING_HEADER;
+	dwin->rx_frame_len = 0;
+	dwin_ring_buffer_reset(dwin);
+
+	dwin_error_t ret_status = dwin_itf_uart_set_baud(dwin, baud);
+	if (ret_status == DWIN_ERROR_NOERR) {
+		dwin_set_link_baud(dwin, baud);
+		ret_status = dwin_itf_uart_receive_to_idle_dma(dwin);
+	}
+	if (ret_status != DWIN_ERROR_NOERR) {
+		/* dwin_process() keeps trying to restart reception */
+		dwin->status = DWIN_STATUS_UART_ERROR;
+	}
+	return ret_status;
+}
+
+uint32_t dwin_get_link_throughput(dwin_t *dwin) {
+	return dwin->link_baud / DWIN_UART_BITS_PER_BYTE;
+}
+
+uint32_t dwin_get_write_throughput(dwin_t *dwin, uint8_t words_per_frame) {
+	uint64_t data_bytes = 2ull * words_per_frame;
+	uint64_t wire_bits = (uint64_t) DWIN_UART_BITS_PER_BYTE
+			* DWIN_VP_WRITE_TX_FRAME_LEN(words_per_frame);
+	uint64_t turnaround_bits = 0;
+
+	if (!dwin->tx_write_ack) {
+		return (uint32_t) ((data_bytes * dwin->link_baud) / wire_bits);
+	}
+
+	wire_bits += DWIN_UART_BITS_PER_BYTE * DWIN_VP_WRITE_ACK_FRAME_LEN;
+	turnaround_bits =
+			dwin->rtt_valid ?
+					((uint64_t) (dwin->rtt_srtt8 >> 3) * dwin->link_baud)
+							/ DWIN_TICK_HZ :
+					0;
+
+	return (uint32_t) ((data_bytes * dwin->link_baud)
+			/ (wire_bits + turnaround_bits));
+}
+
+uint32_t dwin_get_rto_ticks(dwin_t *dwin) {
+	return dwin_rto_ticks(dwin);
+}
+
+static dwin_error_t dwin_reg_cb_entry(dwin_t *dwin, uint16_t watch_address,
+		dwin_event_cb_fn_t cb_fn, dwin_event_ctx_cb_fn_t cb_ctx_fn, void *ctx,
+		uint8_t deferred) {
+
 	if (dwin->status == DWIN_STATUS_INIT) {
 		return DWIN_ERROR_ERR;
 	}
 
 	dwin_error_t ret_status = DWIN_ERROR_NOERR;
-	uint8_t index = 0;
+	uint16_t index = 0;
 	for (; index < DWIN_CALLBACK_ADDR_MAX_COUNT; ++index) {
-		if (dwin->cb_fn[index] == NULL) {
+		if ((dwin->cb_fn[index] == NULL) && (dwin->cb_ctx_fn[index] == NULL)) {
 			dwin->cb_address[index] = watch_address;
 			dwin->cb_fn[index] = cb_fn;
+			dwin->cb_ctx_fn[index] = cb_ctx_fn;
+			dwin->cb_ctx[index] = ctx;
+#if DWIN_CB_EVENT_QUEUE_LEN
+			dwin->cb_deferred[index] = deferred;
+#endif
 			break;
 		}
 	}
 	if (index == DWIN_CALLBACK_ADDR_MAX_COUNT) {
 		ret_status = DWIN_ERROR_ERR;
 	}
+#if !DWIN_CB_EVENT_QUEUE_LEN
+	(void) deferred;
+#endif
 	return ret_status;
 }
 
+dwin_error_t dwin_reg_cb(dwin_t *dwin, uint16_t watch_address,
+		dwin_event_cb_fn_t cb_fn) {
+
+	if ((dwin == NULL) || (cb_fn == NULL)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	return dwin_reg_cb_entry(dwin, watch_address, cb_fn, NULL, NULL, 0);
+}
+
+dwin_error_t dwin_reg_cb_ctx(dwin_t *dwin, uint16_t watch_address,
+		dwin_event_ctx_cb_fn_t cb_fn, void *ctx) {
+
+	if ((dwin == NULL) || (cb_fn == NULL)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	return dwin_reg_cb_entry(dwin, watch_address, NULL, cb_fn, ctx, 0);
+}
+
+#if DWIN_CB_EVENT_QUEUE_LEN
+dwin_error_t dwin_reg_cb_deferred(dwin_t *dwin, uint16_t watch_address,
+		dwin_event_ctx_cb_fn_t cb_fn, void *ctx) {
+
+	if ((dwin == NULL) || (cb_fn == NULL)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	return dwin_reg_cb_entry(dwin, watch_address, NULL, cb_fn, ctx, 1);
+}
+
+dwin_error_t dwin_cb_event_dispatch(dwin_t *dwin, uint8_t max_count) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	uint8_t tail = dwin->cb_event_queue_tail;
+
+	if (tail == dwin->cb_event_queue_head) {
+		return DWIN_ERROR_QUEUE;
+	}
+
+	uint16_t count = 0;
+	while ((tail != dwin->cb_event_queue_head)
+			&& ((max_count == 0) || (count < max_count))) {
+		DWIN_COMPILER_BARRIER();
+		dwin_cb_event_t *event = &dwin->cb_event_queue[tail
+				& DWIN_CB_EVENT_QUEUE_MASK];
+		uint16_t i = event->cb_index;
+
+		(*(dwin->cb_ctx_fn[i]))(dwin->cb_ctx[i],
+				dwin->cb_event_slab[tail & DWIN_CB_EVENT_QUEUE_MASK],
+				event->data16_count);
+		DWIN_COMPILER_BARRIER();
+		dwin->cb_event_queue_tail = ++tail;
+		++count;
+	}
+
+	return DWIN_ERROR_NOERR;
+}
+#endif
+
+dwin_error_t dwin_reg_upload_cb(dwin_t *dwin, dwin_upload_cb_fn_t cb_fn) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (dwin->status == DWIN_STATUS_INIT) {
+		return DWIN_ERROR_ERR;
+	}
+
+	dwin->upload_cb_fn = cb_fn;
+	return DWIN_ERROR_NOERR;
+}
+
+#if DWIN_RX_FRAME_QUEUE_LEN
+dwin_error_t dwin_reg_upload_isr_cb(dwin_t *dwin, dwin_upload_cb_fn_t cb_fn) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (dwin->status == DWIN_STATUS_INIT) {
+		return DWIN_ERROR_ERR;
+	}
+
+	dwin->upload_isr_cb_fn = cb_fn;
+	return DWIN_ERROR_NOERR;
+}
+#endif
+
+#if DWIN_USE_STATS
+const dwin_stats_t* dwin_get_stats(dwin_t *dwin) {
+	return &dwin->stats;
+}
+
+void dwin_stats_reset(dwin_t *dwin) {
+	memset(&dwin->stats, 0, sizeof(dwin->stats));
+}
+#endif
+
 uint8_t dwin_is_tx_idle(dwin_t *dwin) {
 	return dwin->tx_state == DWIN_TX_STATUS_IDLE ? 1 : 0;
 }
 
+uint16_t dwin_get_tx_fail_count(dwin_t *dwin) {
+	return dwin->tx_fail_count;
+}
+
+dwin_error_t dwin_tx_cancel(dwin_t *dwin) {
+	if (dwin == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	switch (dwin->tx_state) {
+	case DWIN_TX_STATUS_TX_BUSY_WRITE_VP:
+	case DWIN_TX_STATUS_TX_BUSY_READ_VP:
+		/* still on the wire, the TX complete callback owns the state */
+		return DWIN_ERROR_BUSY;
+	case DWIN_TX_STATUS_IDLE:
+		return DWIN_ERROR_NOERR;
+	case DWIN_TX_STATUS_VP_WRITE_ACK:
+	case DWIN_TX_STATUS_VP_READ_RESPONSE:
+		/* already answered, only release it before the next dwin_process() */
+		dwin->tx_state = DWIN_TX_STATUS_IDLE;
+		return DWIN_ERROR_NOERR;
+	default:
+		break;
+	}
+
+	DWIN_STATS_INC(dwin, tx_cancels);
+	dwin->tx_state = DWIN_TX_STATUS_IDLE;
+	DWIN_WRITE_VERIFY_CANCEL(dwin);
+	return DWIN_ERROR_NOERR;
+}
+
 extern void dwin_uart_error_callback(dwin_t *dwin);
 
 void dwin_uart_tx_callback(dwin_t *dwin) {
+	DWIN_PROF_BEGIN(DWIN_PROF_UART_TX_CB);
 	if (dwin->tx_state == DWIN_TX_STATUS_TX_BUSY_WRITE_VP) {
-		dwin->tx_state = DWIN_TX_STATUS_VP_WRITE_TX_CMPLT;
+		/* without write ACKs the write is done once it is on the wire */
+		dwin->tx_state =
+				dwin->tx_write_ack ?
+						DWIN_TX_STATUS_VP_WRITE_TX_CMPLT : DWIN_TX_STATUS_IDLE;
+#if DWIN_TX_BATCH_LEN
+		if (dwin->tx_state == DWIN_TX_STATUS_IDLE) {
+			dwin_batch_chain(dwin);
+		}
+#endif
 	} else if (dwin->tx_state == DWIN_TX_STATUS_TX_BUSY_READ_VP) {
 		dwin->tx_state = DWIN_TX_STATUS_VP_READ_TX_CMPLT;
 	}
+	DWIN_PROF_END(DWIN_PROF_UART_TX_CB);
 }
 
 extern void dwin_uart_rx_callback(dwin_t *dwin,
@@ -9,6 +9,8 @@
 #define INC_DWIN_H_
 
 #include "stdint.h"
+#include "dwin_conf.h"
+#include "dwin_prof.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -16,9 +18,96 @@ extern "C"
 #endif
 
 #define DWIN_RX_CIRC_BUF_MAX_LEN 64
-#define DWIN_RX_FRAME_MAX_LEN 16
-#define DWIN_TX_FRAME_MAX_LEN 16
-#define DWIN_CALLBACK_ADDR_MAX_COUNT 8
+#if DWIN_RX_RING_STATIC_LEN >= DWIN_RX_CIRC_BUF_MAX_LEN
+#error DWIN_RX_RING_STATIC_LEN should be less than DWIN_RX_CIRC_BUF_MAX_LEN
+#endif
+
+/*
+ * Link statistics. Define DWIN_USE_STATS as 1 to add a dwin_stats_t block to
+ * every dwin_t. When 0, the counters compile to nothing.
+ */
+#define DWIN_STATS_LATENCY_BUCKETS 16
+/*
+ * Timestamp used for the request to ACK latency histogram. Defaults to the
+ * tick passed to the API, can be redefined to a cycle counter (e.g. DWT->CYCCNT).
+ */
+#ifndef DWIN_STATS_TIMESTAMP
+#define DWIN_STATS_TIMESTAMP(ctick) (ctick)
+#endif
+
+/*
+ * Largest number of 16 bit words a single 0x82 write frame can carry.
+ * Limited by DWIN_TX_FRAME_MAX_LEN and by the one byte frame length field.
+ */
+#define DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN 126
+#define DWIN_VP_WRITE_MAX_DATA_LEN \
+	((((DWIN_TX_FRAME_MAX_LEN) - 6) / 2) < DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN ? \
+			(((DWIN_TX_FRAME_MAX_LEN) - 6) / 2) : DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN)
+
+/*
+ * Constant frames for dwin_send_frame(). They expand to an initializer, so the
+ * frame can be declared static const and stays in flash, e.g. a page switch:
+ *
+ *  static const uint8_t page_home[] = DWIN_FRAME_WRITE2(0x0084, 0x5a01, 0x0001);
+ *  dwin_send_frame(&dwin, page_home, sizeof(page_home), HAL_GetTick());
+ */
+#define DWIN_FRAME_BYTES16(word) (uint8_t) ((word) >> 8), (uint8_t) ((word) & 0xff)
+#define DWIN_FRAME_READ(vp_addr, data_len) \
+	{ 0x5a, 0xa5, 0x04, 0x83, DWIN_FRAME_BYTES16(vp_addr), (uint8_t) (data_len) }
+#define DWIN_FRAME_WRITE1(vp_addr, word0) \
+	{ 0x5a, 0xa5, 0x05, 0x82, DWIN_FRAME_BYTES16(vp_addr), \
+		DWIN_FRAME_BYTES16(word0) }
+#define DWIN_FRAME_WRITE2(vp_addr, word0, word1) \
+	{ 0x5a, 0xa5, 0x07, 0x82, DWIN_FRAME_BYTES16(vp_addr), \
+		DWIN_FRAME_BYTES16(word0), DWIN_FRAME_BYTES16(word1) }
+
+/*
+ * Request timeouts. The time allowed for an ACK / read reply is the wire time
+ * of the request and its reply at the link baud rate plus a retransmission
+ * timeout (RTO) estimated from the measured display turnaround, the same way
+ * TCP does (RTO = SRTT + 4 * RTTVAR). Every consecutive timeout doubles the
+ * RTO, up to DWIN_RTO_MAX_BACKOFF doublings; a reply resets it.
+ *
+ * DWIN_TICK_HZ is the rate of the tick passed to the API (HAL_GetTick() by default).
+ */
+#ifndef DWIN_TICK_HZ
+#define DWIN_TICK_HZ 1000
+#endif
+#define DWIN_TICKS_FROM_MS(ms) (((ms) * DWIN_TICK_HZ) / 1000)
+#ifndef DWIN_LINK_BAUD_DEFAULT
+#define DWIN_LINK_BAUD_DEFAULT 115200
+#endif
+/* RTO used until the first reply is measured */
+#ifndef DWIN_RTO_INITIAL_TICKS
+#define DWIN_RTO_INITIAL_TICKS DWIN_TICKS_FROM_MS(50)
+#endif
+#ifndef DWIN_RTO_MIN_TICKS
+#define DWIN_RTO_MIN_TICKS DWIN_TICKS_FROM_MS(3)
+#endif
+#ifndef DWIN_RTO_MAX_TICKS
+#define DWIN_RTO_MAX_TICKS DWIN_TICKS_FROM_MS(1000)
+#endif
+#ifndef DWIN_RTO_MAX_BACKOFF
+#define DWIN_RTO_MAX_BACKOFF 4
+#endif
+/* Times a timed out write / read is sent again before it is reported as failed */
+#ifndef DWIN_TX_RETRY_MAX
+#define DWIN_TX_RETRY_MAX 3
+#endif
+/*
+ * Words of a write remembered for the read-back verification used without
+ * write ACKs, see dwin_set_write_ack(). The reply has to fit DWIN_RX_FRAME_MAX_LEN.
+ */
+#ifndef DWIN_WRITE_VERIFY_MAX_LEN
+#define DWIN_WRITE_VERIFY_MAX_LEN 4
+#endif
+/* Longest gap between two bytes of the same frame, on top of one frame time */
+#ifndef DWIN_RX_FRAME_GAP_TICKS
+#define DWIN_RX_FRAME_GAP_TICKS DWIN_TICKS_FROM_MS(2)
+#endif
+
+/* Keeps the compiler from moving memory accesses across lock-free index updates */
+#define DWIN_COMPILER_BARRIER() __asm volatile ("" ::: "memory")
 
 typedef enum dwin_status_t {
 	DWIN_STATUS_INIT, DWIN_STATUS_OK, DWIN_STATUS_UART_ERROR,
@@ -26,6 +115,7 @@ typedef enum dwin_status_t {
 
 typedef enum dwin_rx_state_t {
 	DWIN_RX_STATUS_WAITING_HEADER,
+	DWIN_RX_STATUS_WAITING_HEADER_LOW,
 	DWIN_RX_STATUS_WAITING_FRAME_LEN,
 	DWIN_RX_STATUS_WAITING_FN_CODE,
 	DWIN_RX_STATUS_WAITING_DATA,
@@ -42,6 +132,7 @@ typedef enum dwin_tx_state_t {
 	DWIN_TX_STATUS_VP_READ_RESPONSE_WAITING,
 	DWIN_TX_STATUS_VP_WRITE_ACK,
 	DWIN_TX_STATUS_VP_READ_RESPONSE,
+	DWIN_TX_STATUS_RETRY_PENDING,
 } dwin_tx_state_t;
 
 typedef enum dwin_error_t {
@@ -58,27 +149,158 @@ typedef struct dwin_ring_buffer_t {
 	uint8_t *buf_ptr;
 	uint8_t size;
 	int8_t head_index, tail_index;
+	/* bytes reported by the RX events and bytes dequeued, free running */
+	volatile uint32_t write_count;
+	uint32_t read_count;
 } dwin_ring_buffer_t;
 
+#if DWIN_USE_STATS
+typedef struct dwin_stats_t {
+	uint32_t tx_bytes, tx_frames;
+	uint32_t rx_bytes, rx_frames;
+	/* frames given up on (bad length / function code, timeout) and bytes discarded */
+	uint32_t resyncs, dropped_bytes;
+	/* times the RX ring was overwritten before it was drained, and bytes lost */
+	uint32_t rx_overruns, rx_overrun_bytes;
+	uint32_t tx_timeouts, rx_frame_timeouts;
+	/* retransmissions, requests given up on, retries dropped for newer data, dwin_tx_cancel() */
+	uint32_t tx_retries, tx_failures, tx_superseded, tx_cancels;
+	/* batches sent by dwin_batch_flush() and the frames they carried */
+	uint32_t tx_batches, tx_batch_frames;
+	/* batches of those started from the TX complete ISR */
+	uint32_t tx_isr_chained;
+	/* read-backs of writes sent without ACK, and read-backs that did not match */
+	uint32_t write_verify_reads, write_verify_failures;
+	uint32_t busy_rejections;
+	uint32_t uart_error_recoveries;
+	/* frames assembled in the RX ISR and dropped because the frame queue was full */
+	uint32_t rx_frame_queue_drops;
+	/* uploads consumed by the dwin_reg_upload_isr_cb() hook, never queued */
+	uint32_t rx_isr_uploads;
+	/* deferred callback events dropped, queue full or data too long */
+	uint32_t cb_event_drops;
+	/* bucket n counts latencies in [2^(n-1), 2^n), bucket 0 counts 0 */
+	uint32_t ack_latency_hist[DWIN_STATS_LATENCY_BUCKETS];
+} dwin_stats_t;
+#endif
+
+#if DWIN_RX_FRAME_QUEUE_LEN
+typedef struct dwin_rx_frame_t {
+	uint16_t len;
+	uint8_t data[DWIN_RX_FRAME_MAX_LEN];
+} dwin_rx_frame_t;
+#endif
+
+#if DWIN_CB_EVENT_QUEUE_LEN
+typedef struct dwin_cb_event_t {
+	uint16_t cb_index;
+	uint8_t data16_count;
+} dwin_cb_event_t;
+#endif
+
+struct dwin_trace_t;
+
 typedef void (*dwin_event_cb_fn_t)(uint8_t *data8_ptr, uint8_t data16_count);
+typedef void (*dwin_event_ctx_cb_fn_t)(void *ctx, uint8_t *data8_ptr,
+		uint8_t data16_count);
+
+/*
+ * Called for 0x83 frames the display sends without being asked
+ * (data auto-upload). Return non zero to consume the frame, zero to let it
+ * fall through to the callbacks registered with dwin_reg_cb().
+ */
+typedef uint8_t (*dwin_upload_cb_fn_t)(uint16_t address, uint8_t *data8_ptr,
+		uint8_t data16_count);
+
+/*
+ * Called from dwin_process() when a write / read is still unanswered after
+ * all retries. is_read is 0 for dwin_write_vp(), 1 for dwin_read_vp().
+ */
+typedef void (*dwin_tx_fail_cb_fn_t)(uint16_t vp_start_addr, uint8_t is_read);
 
 typedef struct dwin_t {
 	void *huart;
 	dwin_ring_buffer_t rx_ring_buffer;
+#if DWIN_RX_RING_STATIC_LEN
+	uint8_t rx_ring_storage[DWIN_RX_RING_STATIC_LEN];
+#endif
 
 	dwin_status_t status;
 
 	dwin_rx_state_t rx_state;
 	uint8_t rx_frame_buffer[DWIN_RX_FRAME_MAX_LEN];
-	uint16_t rx_num_data_bytes_received, rx_data_bytes_len;
-	uint32_t rx_frame_start_tick, rx_frame_timeout_ticks;
+	uint16_t rx_frame_len, rx_data_bytes_len;
+	uint32_t rx_last_byte_tick, rx_frame_timeout_ticks;
+#if DWIN_RX_FRAME_QUEUE_LEN
+	/* SPSC queue, filled by dwin_rx_assemble() in the ISR, drained by dwin_process() */
+	dwin_rx_frame_t rx_frame_queue[DWIN_RX_FRAME_QUEUE_LEN];
+	volatile uint8_t rx_frame_queue_head, rx_frame_queue_tail;
+	dwin_upload_cb_fn_t upload_isr_cb_fn;
+#endif
 
 	dwin_tx_state_t tx_state;
 	uint8_t tx_frame_buffer[DWIN_TX_FRAME_MAX_LEN];
+	/* frame on the wire, tx_frame_buffer or a constant frame from dwin_send_frame() */
+	const uint8_t *tx_frame_ptr;
+	uint16_t tx_frame_len;
+	/* frames in the transmission, more than one for a batch, and ACKs received */
+	uint8_t tx_frame_count, tx_frame_acked;
 	uint32_t tx_last_sent_tick, tx_timeout_ticks;
+	uint32_t tx_wire_ticks;
+	uint8_t tx_retry_count, tx_retry_max;
+	dwin_tx_fail_cb_fn_t tx_fail_cb_fn;
+	/* requests reported to tx_fail_cb_fn since dwin_init(), wraps around */
+	uint16_t tx_fail_count;
+
+#if DWIN_TX_BATCH_LEN
+	/* ping-pong staging, one buffer fills while the other is on the wire */
+	uint8_t tx_batch_buffer[2][DWIN_TX_BATCH_LEN];
+	uint16_t tx_batch_len;
+	uint8_t tx_batch_frames, tx_batch_fill;
+	volatile uint8_t tx_batch_staging;
+	/* start the next batch from the TX complete ISR, see dwin_set_tx_isr_chain() */
+	uint8_t tx_isr_chain;
+#endif
+
+	/* 0 when the display is configured not to ACK 0x82 writes */
+	uint8_t tx_write_ack;
+#if DWIN_USE_WRITE_VERIFY
+	uint8_t tx_verify_interval, tx_verify_countdown;
+	uint8_t tx_verify_pending, tx_verify_inflight;
+	uint16_t tx_verify_addr;
+	uint8_t tx_verify_len;
+	uint8_t tx_verify_data[2 * DWIN_WRITE_VERIFY_MAX_LEN];
+#endif
+
+	uint32_t link_baud;
+	/* smoothed turnaround x8 and its mean deviation x4, in ticks */
+	uint32_t rtt_srtt8, rtt_rttvar4;
+	uint8_t rtt_valid, rto_backoff;
+	uint16_t tx_read_vp_addr;
+	uint8_t tx_read_vp_len;
 
 	uint16_t cb_address[DWIN_CALLBACK_ADDR_MAX_COUNT];
 	dwin_event_cb_fn_t cb_fn[DWIN_CALLBACK_ADDR_MAX_COUNT];
+	dwin_event_ctx_cb_fn_t cb_ctx_fn[DWIN_CALLBACK_ADDR_MAX_COUNT];
+	void *cb_ctx[DWIN_CALLBACK_ADDR_MAX_COUNT];
+	dwin_upload_cb_fn_t upload_cb_fn;
+#if DWIN_CB_EVENT_QUEUE_LEN
+	uint8_t cb_deferred[DWIN_CALLBACK_ADDR_MAX_COUNT];
+	/* SPSC queue, filled by dwin_process(), drained by dwin_cb_event_dispatch() */
+	dwin_cb_event_t cb_event_queue[DWIN_CB_EVENT_QUEUE_LEN];
+	/* slab of fixed size data blocks, block n belongs to queue slot n */
+	uint8_t cb_event_slab[DWIN_CB_EVENT_QUEUE_LEN][DWIN_CB_EVENT_DATA_MAX_LEN];
+	volatile uint8_t cb_event_queue_head, cb_event_queue_tail;
+#endif
+
+#if DWIN_USE_STATS
+	dwin_stats_t stats;
+	uint32_t stats_tx_timestamp;
+#endif
+
+#if DWIN_USE_TRACE
+	struct dwin_trace_t *trace;
+#endif
 } dwin_t;
 
 /**
@@ -93,6 +315,7 @@ dwin_error_t dwin_init(dwin_t *dwin, void *huart, uint8_t ring_buffer_size);
 /**
  * @brief			DWIN lib process function.
  * 					Should be called from the main loop.
+ * 					Parses every byte received since the last call.
  *
  * @param dwin		dwin_t hanle
  * @param c_tick	current tick value
@@ -102,6 +325,9 @@ dwin_error_t dwin_process(dwin_t *dwin, uint32_t c_tick);
 
 /**
  * @brief 					Function to write data to DWIN display VP address
+ * 							A timed out write is sent again by dwin_process(). A new write to the
+ * 							same VP start address while that retry is pending replaces it, so
+ * 							stale data is never replayed.
  *
  * @param dwin				dwin_t hanle
  * @param vp_start_addr		VP start address to which data is to be written
@@ -113,6 +339,21 @@ dwin_error_t dwin_process(dwin_t *dwin, uint32_t c_tick);
 dwin_error_t dwin_write_vp(dwin_t *dwin, uint16_t vp_start_addr,
 		uint16_t *vp_data_buff, uint8_t data_len, uint32_t ctick);
 
+/**
+ * @brief 					Same as dwin_write_vp(), but takes the data already in panel (big endian)
+ * 							byte order, e.g. image, curve or database blocks stored that way.
+ * 							The bytes are copied into the frame as is.
+ *
+ * @param dwin				dwin_t hanle
+ * @param vp_start_addr		VP start address to which data is to be written
+ * @param vp_data_be		2 * data_len bytes, high byte of each word first
+ * @param data_len			data length in 16 bit words
+ * @param ctick				current tick value for checking timeout
+ * @return
+ */
+dwin_error_t dwin_write_vp_raw(dwin_t *dwin, uint16_t vp_start_addr,
+		const uint8_t *vp_data_be, uint8_t data_len, uint32_t ctick);
+
 /**
  * @brief 					Function to read data from DWIN display VP address
  *
@@ -126,6 +367,151 @@ dwin_error_t dwin_write_vp(dwin_t *dwin, uint16_t vp_start_addr,
 dwin_error_t dwin_read_vp(dwin_t *dwin, uint16_t vp_start_addr,
 		uint16_t data_len, uint32_t ctick);
 
+/**
+ * @brief 					Send a prebuilt 0x82 write or 0x83 read frame (see DWIN_FRAME_WRITE1()
+ * 							and friends) as is. The frame is handed to the UART DMA without being
+ * 							copied, so it must stay valid until the request completes; a static
+ * 							const frame in flash costs no RAM. ACK, read reply, timeout and retry
+ * 							handling are the same as for dwin_write_vp() / dwin_read_vp().
+ *
+ * @param dwin				dwin_t hanle
+ * @param frame				complete frame, starting with the 5A A5 header
+ * @param frame_len			frame length in bytes
+ * @param ctick				current tick value for checking timeout
+ * @return					DWIN_ERROR_PARAM if the frame is not a valid write / read frame
+ */
+dwin_error_t dwin_send_frame(dwin_t *dwin, const uint8_t *frame,
+		uint16_t frame_len, uint32_t ctick);
+
+#if DWIN_TX_BATCH_LEN
+/**
+ * @brief 					Stage a write for the next batch. Staged writes are sent back to back
+ * 							in a single DMA transfer by dwin_batch_flush(), or by dwin_process()
+ * 							once the link is idle. Their ACKs are counted in order, a timeout
+ * 							resends only the frames not ACKed yet.
+ *
+ * @param dwin				dwin_t hanle
+ * @param vp_start_addr		VP start address to which data is to be written
+ * @param vp_data_buff		pointer to data, copied into the staging buffer
+ * @param data_len			data length
+ * @return					DWIN_ERROR_QUEUE if the staging buffer is full
+ */
+dwin_error_t dwin_batch_write_vp(dwin_t *dwin, uint16_t vp_start_addr,
+		uint16_t *vp_data_buff, uint8_t data_len);
+
+/**
+ * @brief 			Send the staged writes now if the link is idle.
+ *
+ * @param dwin		dwin_t hanle
+ * @param ctick		current tick value for checking timeout
+ * @return			DWIN_ERROR_BUSY while a request is in flight
+ */
+dwin_error_t dwin_batch_flush(dwin_t *dwin, uint32_t ctick);
+
+/**
+ * @brief 			Let the TX complete interrupt start the next staged batch itself, so
+ * 					back to back batches do not wait for dwin_process(). Only writes
+ * 					without ACK complete in the interrupt (see dwin_set_write_ack()),
+ * 					with ACKs the next batch still starts from dwin_process() once the
+ * 					ACKs are parsed. The tick is read with dwin_itf_get_tick().
+ *
+ * @param dwin		dwin_t hanle
+ * @param enabled	1 to chain from the interrupt, 0 (default) to send from the main loop
+ * @return
+ */
+dwin_error_t dwin_set_tx_isr_chain(dwin_t *dwin, uint8_t enabled);
+#endif
+
+/**
+ * @brief 			Tell the library the UART baud rate, used to size the request and frame timeouts.
+ * 					dwin_init() assumes DWIN_LINK_BAUD_DEFAULT.
+ *
+ * @param dwin		dwin_t hanle
+ * @param baud		UART baud rate
+ * @return
+ */
+dwin_error_t dwin_set_link_baud(dwin_t *dwin, uint32_t baud);
+
+/**
+ * @brief 				Set how many times a timed out write / read is sent again.
+ * 						dwin_init() uses DWIN_TX_RETRY_MAX, 0 disables retries.
+ *
+ * @param dwin			dwin_t hanle
+ * @param retry_max		retry budget per request
+ * @return
+ */
+dwin_error_t dwin_set_tx_retry_max(dwin_t *dwin, uint8_t retry_max);
+
+/**
+ * @brief 				Function to register a callback for requests that failed after all retries.
+ *
+ * @param dwin			dwin_t hanle
+ * @param cb_fn			Function pointer to the callback, NULL to remove it
+ * @return
+ */
+dwin_error_t dwin_reg_tx_fail_cb(dwin_t *dwin, dwin_tx_fail_cb_fn_t cb_fn);
+
+/**
+ * @brief 				Match the write ACK setting of the display (22_Config.bin).
+ * 						Without ACKs a write completes on UART TX complete, so back to back
+ * 						writes go out at wire speed. dwin_init() assumes ACKs are enabled.
+ *
+ * @param dwin			dwin_t hanle
+ * @param ack_enabled	0 if the display does not answer 0x82 writes with 0x4F4B
+ * @return
+ */
+dwin_error_t dwin_set_write_ack(dwin_t *dwin, uint8_t ack_enabled);
+
+#if DWIN_USE_WRITE_VERIFY
+/**
+ * @brief 				Read back every n-th write sent without ACK to catch silent loss.
+ * 						Up to DWIN_WRITE_VERIFY_MAX_LEN words from the write start address are
+ * 						compared. A mismatch or an unanswered read is reported through the
+ * 						callback registered with dwin_reg_tx_fail_cb().
+ *
+ * @param dwin			dwin_t hanle
+ * @param interval		writes between two read-backs, 0 to disable (default)
+ * @return
+ */
+dwin_error_t dwin_set_write_verify_interval(dwin_t *dwin, uint8_t interval);
+#endif
+
+/**
+ * @brief 			Reconfigure the UART to a new baud rate and restart reception.
+ * 					Only the MCU side changes, see dwin_baud.h for switching the display too.
+ *
+ * @param dwin		dwin_t hanle
+ * @param baud		UART baud rate
+ * @return			DWIN_ERROR_BUSY while a request is in flight
+ */
+dwin_error_t dwin_uart_set_baud(dwin_t *dwin, uint32_t baud);
+
+/**
+ * @brief 			Raw link throughput at the current baud rate.
+ *
+ * @param dwin		dwin_t hanle
+ * @return			bytes per second in each direction
+ */
+uint32_t dwin_get_link_throughput(dwin_t *dwin);
+
+/**
+ * @brief 					Effective VP data throughput of back to back dwin_write_vp() calls,
+ * 							counting frame overhead, the ACK and the measured display turnaround.
+ *
+ * @param dwin				dwin_t hanle
+ * @param words_per_frame	VP words written per frame
+ * @return					VP data bytes per second
+ */
+uint32_t dwin_get_write_throughput(dwin_t *dwin, uint8_t words_per_frame);
+
+/**
+ * @brief 			Current retransmission timeout, without the wire time of the frames.
+ *
+ * @param dwin		dwin_t hanle
+ * @return			timeout in ticks
+ */
+uint32_t dwin_get_rto_ticks(dwin_t *dwin);
+
 /**
  * @brief 					Function to register user callbacks on VP data update from display.
  *
@@ -137,6 +523,76 @@ dwin_error_t dwin_read_vp(dwin_t *dwin, uint16_t vp_start_addr,
 dwin_error_t dwin_reg_cb(dwin_t *dwin, uint16_t watch_address,
 		dwin_event_cb_fn_t cb_fn);
 
+/**
+ * @brief 					Same as dwin_reg_cb(), but the callback also gets a user context pointer.
+ * 							Used by the library modules to bind a callback to their own instance.
+ *
+ * @param dwin				dwin_t hanle
+ * @param watch_address		VP address to check for update, upon which the callback function is called.
+ * @param cb_fn				Function pointer to the user callback function
+ * @param ctx				Passed back as the first callback argument
+ * @return
+ */
+dwin_error_t dwin_reg_cb_ctx(dwin_t *dwin, uint16_t watch_address,
+		dwin_event_ctx_cb_fn_t cb_fn, void *ctx);
+
+#if DWIN_CB_EVENT_QUEUE_LEN
+/**
+ * @brief 					Same as dwin_reg_cb_ctx(), but dwin_process() only queues the update
+ * 							and the callback runs from dwin_cb_event_dispatch(), so a slow
+ * 							handler never holds up the RX path or the request timeouts. The
+ * 							data is copied, updates longer than DWIN_CB_EVENT_DATA_MAX_LEN bytes
+ * 							or arriving while the queue is full are dropped.
+ *
+ * @param dwin				dwin_t hanle
+ * @param watch_address		VP address to check for update, upon which the callback function is called.
+ * @param cb_fn				Function pointer to the user callback function
+ * @param ctx				Passed back as the first callback argument
+ * @return
+ */
+dwin_error_t dwin_reg_cb_deferred(dwin_t *dwin, uint16_t watch_address,
+		dwin_event_ctx_cb_fn_t cb_fn, void *ctx);
+
+/**
+ * @brief 				Run the callbacks of queued updates, in the order they arrived. Can be
+ * 						called from the main loop or from its own RTOS task, while another
+ * 						context runs dwin_process().
+ *
+ * @param dwin			dwin_t hanle
+ * @param max_count		most events to handle in this call, 0 for all pending
+ * @return				DWIN_ERROR_QUEUE if no event was pending
+ */
+dwin_error_t dwin_cb_event_dispatch(dwin_t *dwin, uint8_t max_count);
+#endif
+
+/**
+ * @brief 					Function to register a high priority hook for display initiated uploads.
+ * 							Solicited read replies never reach this hook. It runs as soon as the
+ * 							frame is complete, ahead of the dwin_reg_cb() callbacks.
+ *
+ * @param dwin				dwin_t hanle
+ * @param cb_fn				Function pointer to the hook, NULL to remove it
+ * @return
+ */
+dwin_error_t dwin_reg_upload_cb(dwin_t *dwin, dwin_upload_cb_fn_t cb_fn);
+
+#if DWIN_USE_STATS
+/**
+ * @brief 			Link statistics of this instance.
+ *
+ * @param dwin		dwin_t hanle
+ * @return
+ */
+const dwin_stats_t* dwin_get_stats(dwin_t *dwin);
+
+/**
+ * @brief 			Clear all link statistics.
+ *
+ * @param dwin		dwin_t hanle
+ */
+void dwin_stats_reset(dwin_t *dwin);
+#endif
+
 /**
  * @brief 			Function to check if UART is ready for new transmit.
  *
@@ -145,10 +601,61 @@ dwin_error_t dwin_reg_cb(dwin_t *dwin, uint16_t watch_address,
  */
 uint8_t dwin_is_tx_idle(dwin_t *dwin);
 
+/**
+ * @brief 			Number of requests given up on since dwin_init(), the ones reported
+ * 					to the dwin_reg_tx_fail_cb() callback. Wraps around, compare two
+ * 					readings to tell if a sequence of writes all landed.
+ *
+ * @param dwin		dwin_t hanle
+ * @return
+ */
+uint16_t dwin_get_tx_fail_count(dwin_t *dwin);
+
+/**
+ * @brief 			Drop the request waiting for its ACK / reply or a retry, without
+ * 					calling the fail callback. A late reply is still handed to the
+ * 					registered callbacks. A request that already got its ACK / reply
+ * 					is released without waiting for the next dwin_process().
+ *
+ * @param dwin		dwin_t hanle
+ * @return			DWIN_ERROR_BUSY while the request is still being transmitted
+ */
+dwin_error_t dwin_tx_cancel(dwin_t *dwin);
+
+#if DWIN_RX_FRAME_QUEUE_LEN
+/**
+ * @brief 		Parse the received bytes into whole frames and queue them for
+ * 				dwin_process(), which then only runs the handlers. Called from
+ * 				dwin_uart_rx_callback(), the tick is read with dwin_itf_get_tick().
+ *
+ * @param dwin	dwin_t hanle
+ */
+void dwin_rx_assemble(dwin_t *dwin);
+
+/**
+ * @brief 					Function to register a hook for display initiated uploads that runs
+ * 							in the RX event ISR, from dwin_rx_assemble(), as soon as the frame
+ * 							is complete. A frame it consumes is never queued, so it skips the
+ * 							upload hook, the callbacks and the trace. Solicited read replies
+ * 							never reach it. The data is only valid during the call, and the
+ * 							hook must keep to what is safe in the ISR.
+ *
+ * @param dwin				dwin_t hanle
+ * @param cb_fn				Function pointer to the hook, NULL to remove it
+ * @return
+ */
+dwin_error_t dwin_reg_upload_isr_cb(dwin_t *dwin, dwin_upload_cb_fn_t cb_fn);
+#endif
+
 /**
  * @brief	DWIN UART callback to be called after receiving data
  *			Can be called from:
  *				void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size){}
+ *			With a circular RX DMA it is called on half transfer, transfer complete
+ *			and idle line, so at most half a ring arrives between two calls and
+ *			the bytes received are counted exactly. Keep the DMA half transfer
+ *			interrupt enabled. Bytes overwritten before dwin_process() (or
+ *			dwin_rx_assemble()) drained them are counted as overrun.
  *
  * @param dwin						dwin_t hanle
  * @param last_byte_pos_in_buffer	position of the last byte received in the uart rx buffer
@@ -157,7 +664,18 @@ uint8_t dwin_is_tx_idle(dwin_t *dwin);
  */
 inline void dwin_uart_rx_callback(dwin_t *dwin,
 		uint16_t last_byte_pos_in_buffer) {
-	dwin->rx_ring_buffer.head_index = last_byte_pos_in_buffer;
+	DWIN_PROF_BEGIN(DWIN_PROF_UART_RX_CB);
+	dwin_ring_buffer_t *ring = &dwin->rx_ring_buffer;
+	/* head_index is -1 until the first event, when the data starts at 0 */
+	uint16_t data_end = ring->head_index + 1;
+
+	ring->write_count += (last_byte_pos_in_buffer + 1 + ring->size - data_end)
+			% ring->size;
+	ring->head_index = last_byte_pos_in_buffer;
+#if DWIN_RX_FRAME_QUEUE_LEN
+	dwin_rx_assemble(dwin);
+#endif
+	DWIN_PROF_END(DWIN_PROF_UART_RX_CB);
 }
 
 /**
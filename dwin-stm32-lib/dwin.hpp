@@ -0,0 +1,309 @@
+/*
+ * dwin.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_HPP_
+#define DWIN_STM32_LIB_DWIN_HPP_
+
+#include "dwin.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+/*
+ * Typed VP bindings for C++17 firmware. A Vp<T, Address> is an empty type that
+ * knows at compile time how many 16 bit words T takes on the display and how
+ * to pack it big endian, so reads and writes go straight to dwin_read_vp() /
+ * dwin_write_vp() without any runtime size handling. Frame lengths are
+ * checked against DWIN_TX_FRAME_MAX_LEN / DWIN_RX_FRAME_MAX_LEN with
+ * static_assert.
+ *
+ * Supported types: uint16_t, int32_t, float (IEEE 754, as the display stores
+ * it) and std::array of those. 32 bit values take two VPs, high word first.
+ *
+ *  using Speed = dwin::Vp<uint16_t, 0x5000>;
+ *  using Setpoint = dwin::Vp<float, 0x5002>;
+ *
+ *  Speed::write(&hdwin, 1200, HAL_GetTick());
+ *  Setpoint::on_update(&hdwin, [](float value) { ... });
+ *
+ * Constant frames are built at compile time into .rodata and sent by
+ * dwin_send_frame() without a copy:
+ *
+ *  dwin::send(&hdwin, dwin::write_frame<0x0084, 0x5a01, 0x0001>, ctick);
+ *
+ * Callbacks can be plain functions or lambdas. A lambda passed by value is
+ * copied into static storage owned by its type (one slot per lambda, no heap),
+ * a handler passed by reference must outlive the registration. No RTTI or
+ * exceptions are used.
+ */
+
+namespace dwin {
+
+template<typename T, typename Enable = void>
+struct Codec;
+
+template<>
+struct Codec<uint16_t> {
+	static constexpr std::size_t words = 1;
+
+	static constexpr void encode(uint16_t value, uint16_t *out) {
+		out[0] = value;
+	}
+
+	static constexpr uint16_t decode(const uint8_t *data8_ptr) {
+		return static_cast<uint16_t>((data8_ptr[0] << 8) | data8_ptr[1]);
+	}
+};
+
+template<>
+struct Codec<int32_t> {
+	static constexpr std::size_t words = 2;
+
+	static constexpr void encode(int32_t value, uint16_t *out) {
+		out[0] = static_cast<uint16_t>(static_cast<uint32_t>(value) >> 16);
+		out[1] = static_cast<uint16_t>(static_cast<uint32_t>(value) & 0xffff);
+	}
+
+	static constexpr int32_t decode(const uint8_t *data8_ptr) {
+		return static_cast<int32_t>((static_cast<uint32_t>(data8_ptr[0]) << 24)
+				| (static_cast<uint32_t>(data8_ptr[1]) << 16)
+				| (static_cast<uint32_t>(data8_ptr[2]) << 8)
+				| static_cast<uint32_t>(data8_ptr[3]));
+	}
+};
+
+template<>
+struct Codec<float> {
+	static_assert(sizeof(float) == sizeof(int32_t), "float should be 32 bit");
+
+	static constexpr std::size_t words = 2;
+
+	static void encode(float value, uint16_t *out) {
+		int32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		Codec<int32_t>::encode(bits, out);
+	}
+
+	static float decode(const uint8_t *data8_ptr) {
+		int32_t bits = Codec<int32_t>::decode(data8_ptr);
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+};
+
+template<typename E, std::size_t N>
+struct Codec<std::array<E, N>> {
+	static_assert(N > 0, "empty VP array");
+
+	static constexpr std::size_t words = N * Codec<E>::words;
+
+	static constexpr void encode(const std::array<E, N> &value, uint16_t *out) {
+		for (std::size_t i = 0; i < N; ++i) {
+			Codec<E>::encode(value[i], &out[i * Codec<E>::words]);
+		}
+	}
+
+	static constexpr std::array<E, N> decode(const uint8_t *data8_ptr) {
+		std::array<E, N> value { };
+		for (std::size_t i = 0; i < N; ++i) {
+			value[i] = Codec<E>::decode(&data8_ptr[i * 2 * Codec<E>::words]);
+		}
+		return value;
+	}
+};
+
+template<uint16_t Address, uint16_t... Words>
+constexpr std::array<uint8_t, 6 + (2 * sizeof...(Words))> build_write_frame() {
+	static_assert(sizeof...(Words) > 0, "empty VP write frame");
+	static_assert(sizeof...(Words) <= DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN,
+			"VP write frame too long");
+
+	const uint16_t words[] = { Words... };
+	std::array<uint8_t, 6 + (2 * sizeof...(Words))> frame { 0x5a, 0xa5,
+			static_cast<uint8_t>(3 + (2 * sizeof...(Words))), 0x82,
+			static_cast<uint8_t>(Address >> 8),
+			static_cast<uint8_t>(Address & 0xff) };
+	for (std::size_t i = 0; i < sizeof...(Words); ++i) {
+		frame[6 + (2 * i)] = static_cast<uint8_t>(words[i] >> 8);
+		frame[6 + (2 * i) + 1] = static_cast<uint8_t>(words[i] & 0xff);
+	}
+	return frame;
+}
+
+/* Constant 0x82 write of Words to the VPs starting at Address */
+template<uint16_t Address, uint16_t... Words>
+inline constexpr std::array<uint8_t, 6 + (2 * sizeof...(Words))> write_frame =
+		build_write_frame<Address, Words...>();
+
+/* Constant 0x83 read of Len words starting at Address */
+template<uint16_t Address, uint8_t Len>
+inline constexpr std::array<uint8_t, 7> read_frame = { 0x5a, 0xa5, 0x04, 0x83,
+		static_cast<uint8_t>(Address >> 8), static_cast<uint8_t>(Address & 0xff),
+		Len };
+
+/**
+ * @brief 			Send a constant frame, see dwin_send_frame().
+ *
+ * @param dwin		dwin_t hanle
+ * @param frame		write_frame<...> or read_frame<...>
+ * @param ctick		current tick value for checking timeout
+ * @return
+ */
+template<std::size_t N>
+inline dwin_error_t send(dwin_t *dwin, const std::array<uint8_t, N> &frame,
+		uint32_t ctick) {
+	return dwin_send_frame(dwin, frame.data(), static_cast<uint16_t>(N), ctick);
+}
+
+template<typename T, uint16_t Address>
+class Vp {
+public:
+	using value_type = T;
+
+	static constexpr uint16_t address = Address;
+	static constexpr std::size_t words = Codec<T>::words;
+	/* 5A A5 len 82 addr(2) data */
+	static constexpr std::size_t write_frame_len = 6 + (2 * words);
+	/* 5A A5 len 83 addr(2) n data */
+	static constexpr std::size_t read_reply_frame_len = 7 + (2 * words);
+
+	static_assert(words <= DWIN_VP_WRITE_MAX_DATA_LEN,
+			"VP write frame does not fit DWIN_TX_FRAME_MAX_LEN");
+	static_assert(read_reply_frame_len <= DWIN_RX_FRAME_MAX_LEN,
+			"VP read reply does not fit DWIN_RX_FRAME_MAX_LEN");
+	static_assert(static_cast<uint32_t>(Address) + words - 1 <= 0xffff,
+			"VP range past the end of the address space");
+
+	Vp() = delete;
+
+	/**
+	 * @brief 			Pack a value into the words dwin_write_vp() sends.
+	 *
+	 * @param value		value to pack
+	 * @return			VP words, high word first
+	 */
+	static constexpr std::array<uint16_t, words> pack(const T &value) {
+		std::array<uint16_t, words> data { };
+		Codec<T>::encode(value, data.data());
+		return data;
+	}
+
+	/**
+	 * @brief 			Write the value to the VP, see dwin_write_vp().
+	 *
+	 * @param dwin		dwin_t hanle
+	 * @param value		value to write
+	 * @param ctick		current tick value for checking timeout
+	 * @return
+	 */
+	static dwin_error_t write(dwin_t *dwin, const T &value, uint32_t ctick) {
+		std::array<uint16_t, words> data = pack(value);
+		return dwin_write_vp(dwin, Address, data.data(),
+				static_cast<uint8_t>(words), ctick);
+	}
+
+	/**
+	 * @brief 			Request the VP value, see dwin_read_vp(). The reply is
+	 * 					delivered to the handler registered with on_update().
+	 *
+	 * @param dwin		dwin_t hanle
+	 * @param ctick		current tick value for checking timeout
+	 * @return
+	 */
+	static dwin_error_t read(dwin_t *dwin, uint32_t ctick) {
+		return send(dwin, read_frame<Address, words>, ctick);
+	}
+
+	/**
+	 * @brief 			Unpack a value from the big endian VP data of a frame.
+	 *
+	 * @param data8_ptr	frame data, at least 2 * words bytes
+	 * @return
+	 */
+	static constexpr T unpack(const uint8_t *data8_ptr) {
+		return Codec<T>::decode(data8_ptr);
+	}
+
+	/**
+	 * @brief 			Call handler(T) when the display sends the VP, either as
+	 * 					a read reply or as a data auto-upload. The handler is
+	 * 					copied into static storage, one slot per handler type.
+	 *
+	 * @param dwin		dwin_t hanle
+	 * @param handler	function or lambda taking T
+	 * @return
+	 */
+	template<typename F, typename = std::enable_if_t<
+			!std::is_lvalue_reference<F>::value
+					|| std::is_function<std::remove_reference_t<F>>::value>>
+	static dwin_error_t on_update(dwin_t *dwin, F &&handler) {
+		using H = std::decay_t<F>;
+		static_assert(std::is_invocable<H&, T>::value,
+				"handler should be callable with the VP value type");
+
+		H *slot = Slot<H>::store(std::forward<F>(handler));
+		return dwin_reg_cb_ctx(dwin, Address, &trampoline<H>, slot);
+	}
+
+	/**
+	 * @brief 			Same as above, but keeps a pointer to the handler, which
+	 * 					must stay alive as long as the registration.
+	 *
+	 * @param dwin		dwin_t hanle
+	 * @param handler	function object taking T
+	 * @return
+	 */
+	template<typename H, typename = std::enable_if_t<!std::is_function<H>::value>>
+	static dwin_error_t on_update(dwin_t *dwin, H &handler) {
+		static_assert(std::is_invocable<H&, T>::value,
+				"handler should be callable with the VP value type");
+
+		return dwin_reg_cb_ctx(dwin, Address, &trampoline<H>,
+				const_cast<void*>(static_cast<const void*>(&handler)));
+	}
+
+private:
+	template<typename H>
+	struct Slot {
+		alignas(H) static inline unsigned char storage[sizeof(H)];
+		static inline H *handler = nullptr;
+
+		static H* store(H &&value) {
+			if (handler != nullptr) {
+				handler->~H();
+			}
+			handler = new (storage) H(std::move(value));
+			return handler;
+		}
+
+		static H* store(const H &value) {
+			if (handler != nullptr) {
+				handler->~H();
+			}
+			handler = new (storage) H(value);
+			return handler;
+		}
+	};
+
+	template<typename H>
+	static void trampoline(void *ctx, uint8_t *data8_ptr,
+			uint8_t data16_count) {
+		if (static_cast<std::size_t>(data16_count) < words) {
+			return;
+		}
+		(*static_cast<H*>(ctx))(unpack(data8_ptr));
+	}
+};
+
+} /* namespace dwin */
+
+#endif /* DWIN_STM32_LIB_DWIN_HPP_ */
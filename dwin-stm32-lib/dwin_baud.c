@@ -0,0 +1,163 @@
+/*
+ * dwin_baud.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#include "dwin_baud.h"
+
+#if DWIN_USE_BAUD
+
+#include <stddef.h>
+
+static const uint8_t dwin_baud_cfg_read_frame[] = DWIN_FRAME_READ(
+		DWIN_BAUD_CFG_VP, DWIN_BAUD_CFG_VP_LEN);
+
+static void dwin_baud_verify_cb(void *ctx, uint8_t *data8_ptr,
+		uint8_t data16_count) {
+	dwin_baud_t *baud = (dwin_baud_t*) ctx;
+
+	if ((baud->state != DWIN_BAUD_STATE_VERIFY_WAITING)
+			|| (data16_count != DWIN_BAUD_CFG_VP_LEN)) {
+		return;
+	}
+
+	/*
+	 * A panel that ignored the config write still answers at a shared rate.
+	 * Only the divisor is compared, the panel clears the 0x5A enable flag
+	 * once the write is applied.
+	 */
+	if (((data8_ptr[2] << 8) | data8_ptr[3]) == baud->cfg[1]) {
+		baud->verified = 1;
+	}
+}
+
+static dwin_error_t dwin_baud_write_cfg(dwin_baud_t *baud, uint32_t rate,
+		uint32_t ctick) {
+	dwin_t *dwin = baud->dwin;
+	dwin_error_t error;
+
+	baud->cfg[0] = DWIN_BAUD_CFG_WRITE_ENABLE;
+	baud->cfg[1] = DWIN_BAUD_CFG_DIVISOR(rate);
+	/* the ACK may already come at the new rate, a retry would only confuse the display */
+	baud->saved_retry_max = dwin->tx_retry_max;
+	dwin->tx_retry_max = 0;
+	error = dwin_write_vp(dwin, DWIN_BAUD_CFG_VP, baud->cfg,
+	DWIN_BAUD_CFG_VP_LEN, ctick);
+	if (error != DWIN_ERROR_NOERR) {
+		dwin->tx_retry_max = baud->saved_retry_max;
+	}
+	return error;
+}
+
+dwin_error_t dwin_baud_init(dwin_baud_t *baud, dwin_t *dwin) {
+	if ((baud == NULL) || (dwin == NULL)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	baud->dwin = dwin;
+	baud->state = DWIN_BAUD_STATE_IDLE;
+	baud->verified = 0;
+
+	return dwin_reg_cb_ctx(dwin, DWIN_BAUD_CFG_VP, dwin_baud_verify_cb, baud);
+}
+
+dwin_error_t dwin_baud_start(dwin_baud_t *baud, uint32_t target_baud) {
+	if ((baud == NULL) || (target_baud == 0)) {
+		return DWIN_ERROR_PARAM;
+	}
+	/* a truncated divisor would leave the panel at a rate the MCU never uses */
+	if (!DWIN_BAUD_CFG_RATE_VALID(target_baud)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if ((baud->state != DWIN_BAUD_STATE_IDLE)
+			&& (baud->state != DWIN_BAUD_STATE_DONE)
+			&& (baud->state != DWIN_BAUD_STATE_FAILED)) {
+		return DWIN_ERROR_BUSY;
+	}
+
+	baud->target_baud = target_baud;
+	baud->state = DWIN_BAUD_STATE_WRITE_RATE;
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_baud_process(dwin_baud_t *baud, uint32_t ctick) {
+	if (baud == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin_t *dwin = baud->dwin;
+
+	switch (baud->state) {
+	case DWIN_BAUD_STATE_IDLE:
+	case DWIN_BAUD_STATE_DONE:
+		return DWIN_ERROR_NOERR;
+	case DWIN_BAUD_STATE_FAILED:
+		return DWIN_ERROR_ERR;
+	case DWIN_BAUD_STATE_WRITE_RATE:
+		if (!dwin_is_tx_idle(dwin)) {
+			break;
+		}
+		baud->fallback_baud = dwin->link_baud;
+		if (dwin_baud_write_cfg(baud, baud->target_baud, ctick)
+				== DWIN_ERROR_NOERR) {
+			baud->state = DWIN_BAUD_STATE_WRITE_RATE_WAITING;
+		}
+		break;
+	case DWIN_BAUD_STATE_WRITE_RATE_WAITING:
+		/* ACK or timeout, the display may have switched either way */
+		if (dwin_is_tx_idle(dwin)) {
+			dwin->tx_retry_max = baud->saved_retry_max;
+			dwin_uart_set_baud(dwin, baud->target_baud);
+			baud->switch_tick = ctick;
+			baud->state = DWIN_BAUD_STATE_SWITCH_WAITING;
+		}
+		break;
+	case DWIN_BAUD_STATE_SWITCH_WAITING:
+		if ((ctick - baud->switch_tick) >= DWIN_BAUD_SWITCH_TICKS) {
+			baud->state = DWIN_BAUD_STATE_VERIFY;
+		}
+		break;
+	case DWIN_BAUD_STATE_VERIFY:
+		baud->verified = 0;
+		if (dwin_send_frame(dwin, dwin_baud_cfg_read_frame,
+				sizeof(dwin_baud_cfg_read_frame), ctick) == DWIN_ERROR_NOERR) {
+			baud->state = DWIN_BAUD_STATE_VERIFY_WAITING;
+		}
+		break;
+	case DWIN_BAUD_STATE_VERIFY_WAITING:
+		/* the read is retried by dwin_process() before the link gives up */
+		if (!dwin_is_tx_idle(dwin)) {
+			break;
+		}
+		if (baud->verified) {
+			baud->state = DWIN_BAUD_STATE_DONE;
+			return DWIN_ERROR_NOERR;
+		}
+		baud->state = DWIN_BAUD_STATE_RESTORE;
+		break;
+	case DWIN_BAUD_STATE_RESTORE:
+		/* the panel may have switched anyway, ask it to go back at the new rate */
+		if (dwin_baud_write_cfg(baud, baud->fallback_baud, ctick)
+				== DWIN_ERROR_NOERR) {
+			baud->state = DWIN_BAUD_STATE_RESTORE_WAITING;
+		}
+		break;
+	case DWIN_BAUD_STATE_RESTORE_WAITING:
+		if (!dwin_is_tx_idle(dwin)) {
+			break;
+		}
+		dwin->tx_retry_max = baud->saved_retry_max;
+		dwin_uart_set_baud(dwin, baud->fallback_baud);
+		baud->state = DWIN_BAUD_STATE_FAILED;
+		return DWIN_ERROR_ERR;
+	default:
+		break;
+	}
+
+	return DWIN_ERROR_BUSY;
+}
+
+#endif
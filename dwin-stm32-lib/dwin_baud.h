@@ -0,0 +1,118 @@
+/*
+ * dwin_baud.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_BAUD_H_
+#define DWIN_STM32_LIB_DWIN_BAUD_H_
+
+#include "dwin.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Runtime baud rate upgrade:
+ *  1. write the new rate to the display config register at the current rate
+ *  2. reconfigure the MCU UART
+ *  3. read the config register back at the new rate
+ *  4. if the read does not return the written divisor, write the old rate
+ *     to the display at the new rate and go back to the old rate
+ *
+ * The register value follows the T5L CFG encoding: a 0x5A write enable word
+ * followed by the UART divisor (3225600 / baud). Only rates that divide the
+ * clock evenly can be reached, e.g. 230400 or 460800 but not 921600.
+ * Redefine the macros below if the panel firmware expects a different layout.
+ */
+#ifndef DWIN_BAUD_CFG_VP
+#define DWIN_BAUD_CFG_VP 0x0080
+#endif
+#ifndef DWIN_BAUD_CFG_WRITE_ENABLE
+#define DWIN_BAUD_CFG_WRITE_ENABLE 0x5a00
+#endif
+#ifndef DWIN_BAUD_CFG_CLOCK
+#define DWIN_BAUD_CFG_CLOCK 3225600UL
+#endif
+#ifndef DWIN_BAUD_CFG_DIVISOR
+#define DWIN_BAUD_CFG_DIVISOR(baud) ((uint16_t) (DWIN_BAUD_CFG_CLOCK / (baud)))
+#endif
+#ifndef DWIN_BAUD_CFG_RATE_VALID
+#define DWIN_BAUD_CFG_RATE_VALID(baud) ((DWIN_BAUD_CFG_CLOCK % (baud)) == 0)
+#endif
+#define DWIN_BAUD_CFG_VP_LEN 2
+
+/* Time given to the display to switch before the verification read */
+#ifndef DWIN_BAUD_SWITCH_TICKS
+#define DWIN_BAUD_SWITCH_TICKS DWIN_TICKS_FROM_MS(10)
+#endif
+
+typedef enum dwin_baud_state_t {
+	DWIN_BAUD_STATE_IDLE,
+	DWIN_BAUD_STATE_WRITE_RATE,
+	DWIN_BAUD_STATE_WRITE_RATE_WAITING,
+	DWIN_BAUD_STATE_SWITCH_WAITING,
+	DWIN_BAUD_STATE_VERIFY,
+	DWIN_BAUD_STATE_VERIFY_WAITING,
+	DWIN_BAUD_STATE_RESTORE,
+	DWIN_BAUD_STATE_RESTORE_WAITING,
+	DWIN_BAUD_STATE_DONE,
+	DWIN_BAUD_STATE_FAILED,
+} dwin_baud_state_t;
+
+typedef struct dwin_baud_t {
+	dwin_t *dwin;
+
+	dwin_baud_state_t state;
+	uint32_t target_baud, fallback_baud;
+	uint32_t switch_tick;
+	uint8_t verified, saved_retry_max;
+	uint16_t cfg[DWIN_BAUD_CFG_VP_LEN];
+} dwin_baud_t;
+
+#if DWIN_USE_BAUD
+
+/**
+ * @brief 			Baud rate negotiation init function.
+ * 					Should be called after dwin_init().
+ *
+ * @param baud		dwin_baud_t handle
+ * @param dwin		dwin_t hanle
+ * @return
+ */
+dwin_error_t dwin_baud_init(dwin_baud_t *baud, dwin_t *dwin);
+
+/**
+ * @brief 				Start switching the link to a new baud rate.
+ * 						Keep calling dwin_baud_process() until it stops returning DWIN_ERROR_BUSY.
+ *
+ * @param baud			dwin_baud_t handle
+ * @param target_baud	new baud rate, e.g. 460800
+ * @return				DWIN_ERROR_BUSY if a negotiation is already running,
+ * 						DWIN_ERROR_PARAM if the panel can not run at exactly that rate
+ */
+dwin_error_t dwin_baud_start(dwin_baud_t *baud, uint32_t target_baud);
+
+/**
+ * @brief 			Negotiation process function.
+ * 					Should be called from the main loop. No other requests should be sent
+ * 					while it returns DWIN_ERROR_BUSY.
+ *
+ * @param baud		dwin_baud_t handle
+ * @param ctick		current tick value
+ * @return			DWIN_ERROR_BUSY while negotiating,
+ * 					DWIN_ERROR_NOERR once the new rate is verified (or when idle),
+ * 					DWIN_ERROR_ERR after falling back to the previous rate
+ */
+dwin_error_t dwin_baud_process(dwin_baud_t *baud, uint32_t ctick);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWIN_STM32_LIB_DWIN_BAUD_H_ */
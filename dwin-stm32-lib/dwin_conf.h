@@ -0,0 +1,166 @@
+/*
+ * dwin_conf.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_CONF_H_
+#define DWIN_STM32_LIB_DWIN_CONF_H_
+
+/*
+ * Compile time configuration. Select a profile with -DDWIN_CONF_PROFILE=...,
+ * every setting below can still be overridden on its own with -D.
+ *
+ *  DWIN_CONF_PROFILE_MINIMAL: short frames, 4 callbacks, 32 byte static RX
+ *  ring (no heap), optional modules compiled out. For parts smaller than the
+ *  STM32L431.
+ *
+ *  DWIN_CONF_PROFILE_STANDARD: the defaults used by the example project. Its
+ *  16 byte frames leave out dwin_sys, the snapshot reply does not fit.
+ *
+ *  DWIN_CONF_PROFILE_HIGH_THROUGHPUT: full size frames (126 word writes,
+ *  125 word reads), 32 callbacks, static RX ring, deeper touch event queue,
+ *  larger write batches.
+ *
+ * Diagnostics (DWIN_USE_STATS, DWIN_USE_TRACE, DWIN_USE_PROFILING) are off in
+ * every profile. tools/size_report.sh prints the flash and RAM cost of each
+ * profile.
+ */
+#define DWIN_CONF_PROFILE_MINIMAL 0
+#define DWIN_CONF_PROFILE_STANDARD 1
+#define DWIN_CONF_PROFILE_HIGH_THROUGHPUT 2
+
+#ifndef DWIN_CONF_PROFILE
+#define DWIN_CONF_PROFILE DWIN_CONF_PROFILE_STANDARD
+#endif
+
+#if DWIN_CONF_PROFILE == DWIN_CONF_PROFILE_MINIMAL
+#define DWIN_CONF_FRAME_MAX_LEN 16
+#define DWIN_CONF_CALLBACK_ADDR_MAX_COUNT 4
+#define DWIN_CONF_RX_RING_STATIC_LEN 32
+#define DWIN_CONF_TOUCH_EVENT_QUEUE_LEN 4
+#define DWIN_CONF_TX_BATCH_LEN 0
+#define DWIN_CONF_USE_MODULES 0
+#elif DWIN_CONF_PROFILE == DWIN_CONF_PROFILE_STANDARD
+#define DWIN_CONF_FRAME_MAX_LEN 16
+#define DWIN_CONF_CALLBACK_ADDR_MAX_COUNT 8
+#define DWIN_CONF_RX_RING_STATIC_LEN 0
+#define DWIN_CONF_TOUCH_EVENT_QUEUE_LEN 8
+#define DWIN_CONF_TX_BATCH_LEN 64
+#define DWIN_CONF_USE_MODULES 1
+#elif DWIN_CONF_PROFILE == DWIN_CONF_PROFILE_HIGH_THROUGHPUT
+#define DWIN_CONF_FRAME_MAX_LEN 258
+#define DWIN_CONF_CALLBACK_ADDR_MAX_COUNT 32
+#define DWIN_CONF_RX_RING_STATIC_LEN 63
+#define DWIN_CONF_TOUCH_EVENT_QUEUE_LEN 16
+#define DWIN_CONF_TX_BATCH_LEN 512
+#define DWIN_CONF_USE_MODULES 1
+#else
+#error Unknown DWIN_CONF_PROFILE
+#endif
+
+/* Frame buffers embedded in dwin_t */
+#ifndef DWIN_RX_FRAME_MAX_LEN
+#define DWIN_RX_FRAME_MAX_LEN DWIN_CONF_FRAME_MAX_LEN
+#endif
+#ifndef DWIN_TX_FRAME_MAX_LEN
+#define DWIN_TX_FRAME_MAX_LEN DWIN_CONF_FRAME_MAX_LEN
+#endif
+
+/* Entries of the dwin_reg_cb() / dwin_reg_cb_ctx() table */
+#ifndef DWIN_CALLBACK_ADDR_MAX_COUNT
+#define DWIN_CALLBACK_ADDR_MAX_COUNT DWIN_CONF_CALLBACK_ADDR_MAX_COUNT
+#endif
+
+/*
+ * RX ring storage embedded in dwin_t, 0 to allocate it from the heap in
+ * dwin_init(). The ring_buffer_size passed to dwin_init() must not exceed it.
+ */
+#ifndef DWIN_RX_RING_STATIC_LEN
+#define DWIN_RX_RING_STATIC_LEN DWIN_CONF_RX_RING_STATIC_LEN
+#endif
+
+/*
+ * Size of each of the two write batch staging buffers embedded in dwin_t,
+ * see dwin_batch_write_vp(). 0 compiles batching out.
+ */
+#ifndef DWIN_TX_BATCH_LEN
+#define DWIN_TX_BATCH_LEN DWIN_CONF_TX_BATCH_LEN
+#endif
+
+/*
+ * Frames assembled in the RX event ISR and queued for dwin_process(), must be
+ * a power of 2 up to 128. 0 parses the RX ring in dwin_process() instead.
+ */
+#ifndef DWIN_RX_FRAME_QUEUE_LEN
+#define DWIN_RX_FRAME_QUEUE_LEN 0
+#endif
+/* Queued frames handled per dwin_process() call, bounds its run time */
+#ifndef DWIN_RX_FRAME_DISPATCH_MAX
+#define DWIN_RX_FRAME_DISPATCH_MAX DWIN_RX_FRAME_QUEUE_LEN
+#endif
+
+/*
+ * Events queued for callbacks registered with dwin_reg_cb_deferred(), must be
+ * a power of 2 up to 128. 0 compiles deferred callbacks out.
+ */
+#ifndef DWIN_CB_EVENT_QUEUE_LEN
+#define DWIN_CB_EVENT_QUEUE_LEN 0
+#endif
+/* Bytes of VP data each queued event can carry, longer updates are dropped */
+#ifndef DWIN_CB_EVENT_DATA_MAX_LEN
+#define DWIN_CB_EVENT_DATA_MAX_LEN 8
+#endif
+
+/* Touch event queue length, must be a power of 2 up to 128 */
+#ifndef DWIN_TOUCH_EVENT_QUEUE_LEN
+#define DWIN_TOUCH_EVENT_QUEUE_LEN DWIN_CONF_TOUCH_EVENT_QUEUE_LEN
+#endif
+
+/* Optional modules, each compiles to nothing when 0 */
+#ifndef DWIN_USE_GFX
+#define DWIN_USE_GFX DWIN_CONF_USE_MODULES
+#endif
+#ifndef DWIN_USE_TOUCH
+#define DWIN_USE_TOUCH DWIN_CONF_USE_MODULES
+#endif
+/* needs an RX frame buffer for the 75 byte register snapshot reply, see dwin_sys.h */
+#ifndef DWIN_USE_SYS
+#if DWIN_RX_FRAME_MAX_LEN >= 75
+#define DWIN_USE_SYS DWIN_CONF_USE_MODULES
+#else
+#define DWIN_USE_SYS 0
+#endif
+#endif
+#ifndef DWIN_USE_BAUD
+#define DWIN_USE_BAUD DWIN_CONF_USE_MODULES
+#endif
+#ifndef DWIN_USE_SHADOW
+#define DWIN_USE_SHADOW DWIN_CONF_USE_MODULES
+#endif
+#ifndef DWIN_USE_STARTUP
+#define DWIN_USE_STARTUP DWIN_CONF_USE_MODULES
+#endif
+#ifndef DWIN_USE_THROTTLE
+#define DWIN_USE_THROTTLE DWIN_CONF_USE_MODULES
+#endif
+/* Read-back verification of writes sent without ACK, see dwin_set_write_ack() */
+#ifndef DWIN_USE_WRITE_VERIFY
+#define DWIN_USE_WRITE_VERIFY DWIN_CONF_USE_MODULES
+#endif
+
+/* Link statistics, see dwin_get_stats() */
+#ifndef DWIN_USE_STATS
+#define DWIN_USE_STATS 0
+#endif
+/* Binary wire trace, see dwin_trace.h */
+#ifndef DWIN_USE_TRACE
+#define DWIN_USE_TRACE 0
+#endif
+/* Hot path profiling, see dwin_prof.h */
+#ifndef DWIN_USE_PROFILING
+#define DWIN_USE_PROFILING 0
+#endif
+
+#endif /* DWIN_STM32_LIB_DWIN_CONF_H_ */
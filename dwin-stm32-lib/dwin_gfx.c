@@ -0,0 +1,227 @@
+/*
+ * dwin_gfx.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#include "dwin_gfx.h"
+
+#if DWIN_USE_GFX
+
+#include <stddef.h>
+
+enum dwin_gfx_header_names {
+	DWIN_GFX_HEADER_NAME_CMD, DWIN_GFX_HEADER_NAME_COUNT,
+};
+
+static dwin_error_t dwin_gfx_append(dwin_gfx_t *gfx, const uint16_t *words,
+		uint8_t word_count) {
+	/* one word is always kept free for the end marker */
+	if ((gfx->used_len + word_count + 1) > gfx->arena_len) {
+		return DWIN_ERROR_MEM_ALLOC;
+	}
+
+	for (uint8_t i = 0; i < word_count; ++i) {
+		gfx->arena[gfx->used_len++] = words[i];
+	}
+	return DWIN_ERROR_NOERR;
+}
+
+static dwin_error_t dwin_gfx_check(dwin_gfx_t *gfx, uint16_t cmd) {
+	if (gfx == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+	if (gfx->state != DWIN_GFX_STATE_BUILDING) {
+		return DWIN_ERROR_ERR;
+	}
+	if (gfx->arena[DWIN_GFX_HEADER_NAME_CMD] != cmd) {
+		return DWIN_ERROR_PARAM;
+	}
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_gfx_init(dwin_gfx_t *gfx, uint16_t vp_addr, uint16_t *arena,
+		uint16_t arena_len) {
+	if ((gfx == NULL) || (arena == NULL)
+			|| (arena_len < DWIN_GFX_ARENA_LEN(0, 0))) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	gfx->vp_addr = vp_addr;
+	gfx->arena = arena;
+	gfx->arena_len = arena_len;
+	gfx->used_len = 0;
+	gfx->sent_len = 0;
+	gfx->fail_count = 0;
+	gfx->state = DWIN_GFX_STATE_EMPTY;
+
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_gfx_begin(dwin_gfx_t *gfx, uint16_t cmd) {
+	if (gfx == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+	if ((gfx->state != DWIN_GFX_STATE_EMPTY)
+			&& (gfx->state != DWIN_GFX_STATE_BUILDING)) {
+		return DWIN_ERROR_BUSY;
+	}
+
+	gfx->arena[DWIN_GFX_HEADER_NAME_CMD] = cmd;
+	gfx->arena[DWIN_GFX_HEADER_NAME_COUNT] = 0;
+	gfx->used_len = DWIN_GFX_HEADER_LEN;
+	gfx->sent_len = 0;
+	gfx->state = DWIN_GFX_STATE_BUILDING;
+
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_gfx_dot(dwin_gfx_t *gfx, uint16_t x, uint16_t y,
+		uint16_t color) {
+	dwin_error_t ret_status = dwin_gfx_check(gfx, DWIN_GFX_CMD_DOT);
+
+	if (ret_status == DWIN_ERROR_NOERR) {
+		uint16_t words[] = { x, y, color };
+		ret_status = dwin_gfx_append(gfx, words, 3);
+	}
+	if (ret_status == DWIN_ERROR_NOERR) {
+		++gfx->arena[DWIN_GFX_HEADER_NAME_COUNT];
+	}
+	return ret_status;
+}
+
+dwin_error_t dwin_gfx_polyline_start(dwin_gfx_t *gfx, uint16_t color,
+		uint16_t x, uint16_t y) {
+	dwin_error_t ret_status = dwin_gfx_check(gfx, DWIN_GFX_CMD_LINE);
+
+	if (ret_status == DWIN_ERROR_NOERR) {
+		if (gfx->used_len != DWIN_GFX_HEADER_LEN) {
+			return DWIN_ERROR_ERR;
+		}
+		uint16_t words[] = { color, x, y };
+		ret_status = dwin_gfx_append(gfx, words, 3);
+	}
+	return ret_status;
+}
+
+dwin_error_t dwin_gfx_polyline_to(dwin_gfx_t *gfx, uint16_t x, uint16_t y) {
+	dwin_error_t ret_status = dwin_gfx_check(gfx, DWIN_GFX_CMD_LINE);
+
+	if (ret_status == DWIN_ERROR_NOERR) {
+		if (gfx->used_len == DWIN_GFX_HEADER_LEN) {
+			return DWIN_ERROR_ERR;
+		}
+		uint16_t words[] = { x, y };
+		ret_status = dwin_gfx_append(gfx, words, 2);
+	}
+	if (ret_status == DWIN_ERROR_NOERR) {
+		++gfx->arena[DWIN_GFX_HEADER_NAME_COUNT];
+	}
+	return ret_status;
+}
+
+dwin_error_t dwin_gfx_rect(dwin_gfx_t *gfx, uint16_t x0, uint16_t y0,
+		uint16_t x1, uint16_t y1, uint16_t color) {
+	dwin_error_t ret_status = dwin_gfx_check(gfx, DWIN_GFX_CMD_RECT);
+
+	if (ret_status == DWIN_ERROR_PARAM) {
+		ret_status = dwin_gfx_check(gfx, DWIN_GFX_CMD_RECT_FILL);
+	}
+	if (ret_status == DWIN_ERROR_NOERR) {
+		uint16_t words[] = { x0, y0, x1, y1, color };
+		ret_status = dwin_gfx_append(gfx, words, 5);
+	}
+	if (ret_status == DWIN_ERROR_NOERR) {
+		++gfx->arena[DWIN_GFX_HEADER_NAME_COUNT];
+	}
+	return ret_status;
+}
+
+dwin_error_t dwin_gfx_commit(dwin_gfx_t *gfx) {
+	if (gfx == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+	if (gfx->state != DWIN_GFX_STATE_BUILDING) {
+		return DWIN_ERROR_ERR;
+	}
+
+	gfx->arena[gfx->used_len++] = DWIN_GFX_END_MARKER;
+	gfx->sent_len = DWIN_GFX_HEADER_LEN;
+	gfx->state = DWIN_GFX_STATE_CLEARING;
+
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_gfx_flush(dwin_gfx_t *gfx, dwin_t *dwin, uint32_t ctick) {
+	if ((gfx == NULL) || (dwin == NULL)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin_error_t ret_status = DWIN_ERROR_NOERR;
+
+	switch (gfx->state) {
+	case DWIN_GFX_STATE_BUILDING:
+		/* the batch has to be committed before anything goes out */
+		return DWIN_ERROR_ERR;
+	case DWIN_GFX_STATE_CLEARING: {
+		/* the previous header is still live, stop the display drawing from it */
+		uint16_t count = 0;
+		gfx->fail_count = dwin_get_tx_fail_count(dwin);
+		ret_status = dwin_write_vp(dwin,
+				gfx->vp_addr + DWIN_GFX_HEADER_NAME_COUNT, &count, 1, ctick);
+		if (ret_status == DWIN_ERROR_NOERR) {
+			gfx->state = DWIN_GFX_STATE_SENDING_DATA;
+			ret_status = DWIN_ERROR_BUSY;
+		}
+		break;
+	}
+	case DWIN_GFX_STATE_SENDING_DATA: {
+		uint16_t chunk_len = gfx->used_len - gfx->sent_len;
+		if (chunk_len > DWIN_VP_WRITE_MAX_DATA_LEN) {
+			chunk_len = DWIN_VP_WRITE_MAX_DATA_LEN;
+		}
+		ret_status = dwin_write_vp(dwin, gfx->vp_addr + gfx->sent_len,
+				&gfx->arena[gfx->sent_len], chunk_len, ctick);
+		if (ret_status == DWIN_ERROR_NOERR) {
+			gfx->sent_len += chunk_len;
+			if (gfx->sent_len == gfx->used_len) {
+				gfx->state = DWIN_GFX_STATE_SENDING_HEADER;
+			}
+			ret_status = DWIN_ERROR_BUSY;
+		}
+		break;
+	}
+	case DWIN_GFX_STATE_SENDING_HEADER:
+		ret_status = dwin_write_vp(dwin, gfx->vp_addr, gfx->arena,
+		DWIN_GFX_HEADER_LEN, ctick);
+		if (ret_status == DWIN_ERROR_NOERR) {
+			gfx->state = DWIN_GFX_STATE_SETTLING;
+			ret_status = DWIN_ERROR_BUSY;
+		}
+		break;
+	case DWIN_GFX_STATE_SETTLING:
+		/* accepted is not delivered, wait for the last ACK or retry */
+		if (!dwin_is_tx_idle(dwin)) {
+			ret_status = DWIN_ERROR_BUSY;
+		} else if (dwin_get_tx_fail_count(dwin) != gfx->fail_count) {
+			ret_status = DWIN_ERROR_TIMEOUT;
+		} else {
+			gfx->state = DWIN_GFX_STATE_EMPTY;
+		}
+		break;
+	default:
+		break;
+	}
+
+	/* an error would repeat on every call, drop the batch instead */
+	if ((ret_status != DWIN_ERROR_NOERR) && (ret_status != DWIN_ERROR_BUSY)) {
+		gfx->used_len = 0;
+		gfx->sent_len = 0;
+		gfx->state = DWIN_GFX_STATE_EMPTY;
+	}
+
+	return ret_status;
+}
+
+#endif
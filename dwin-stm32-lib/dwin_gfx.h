@@ -0,0 +1,140 @@
+/*
+ * dwin_gfx.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_GFX_H_
+#define DWIN_STM32_LIB_DWIN_GFX_H_
+
+#include "dwin.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * DGUS basic graphics VP block:
+ *  VP + 0: command
+ *  VP + 1: number of primitives
+ *  VP + 2: primitive data ..., terminated by 0xff00
+ */
+#define DWIN_GFX_CMD_DOT 0x0001
+#define DWIN_GFX_CMD_LINE 0x0002
+#define DWIN_GFX_CMD_RECT 0x0003
+#define DWIN_GFX_CMD_RECT_FILL 0x0004
+#define DWIN_GFX_END_MARKER 0xff00
+
+#define DWIN_GFX_HEADER_LEN 2
+
+/*
+ * Arena words needed for a block of "count" primitives of "words" each.
+ * Includes the header and the end marker.
+ */
+#define DWIN_GFX_ARENA_LEN(count, words) \
+	(DWIN_GFX_HEADER_LEN + ((count) * (words)) + 1)
+
+typedef enum dwin_gfx_state_t {
+	DWIN_GFX_STATE_EMPTY,
+	DWIN_GFX_STATE_BUILDING,
+	DWIN_GFX_STATE_CLEARING,
+	DWIN_GFX_STATE_SENDING_DATA,
+	DWIN_GFX_STATE_SENDING_HEADER,
+	DWIN_GFX_STATE_SETTLING,
+} dwin_gfx_state_t;
+
+typedef struct dwin_gfx_t {
+	uint16_t vp_addr;
+	uint16_t *arena;
+	uint16_t arena_len;
+	uint16_t used_len;
+	uint16_t sent_len;
+	uint16_t fail_count;
+	dwin_gfx_state_t state;
+} dwin_gfx_t;
+
+#if DWIN_USE_GFX
+
+/**
+ * @brief 				Bind a draw command builder to a basic graphics VP block.
+ *
+ * @param gfx			dwin_gfx_t handle
+ * @param vp_addr		VP address of the basic graphics control
+ * @param arena			preallocated word buffer, see DWIN_GFX_ARENA_LEN()
+ * @param arena_len		arena length in words
+ * @return
+ */
+dwin_error_t dwin_gfx_init(dwin_gfx_t *gfx, uint16_t vp_addr, uint16_t *arena,
+		uint16_t arena_len);
+
+/**
+ * @brief 				Start a new batch of primitives. Drops anything not yet committed.
+ *
+ * @param gfx			dwin_gfx_t handle
+ * @param cmd			one of DWIN_GFX_CMD_*
+ * @return				DWIN_ERROR_BUSY while a previous batch is still being sent
+ */
+dwin_error_t dwin_gfx_begin(dwin_gfx_t *gfx, uint16_t cmd);
+
+/**
+ * @brief 				Append a dot. Batch must be started with DWIN_GFX_CMD_DOT.
+ */
+dwin_error_t dwin_gfx_dot(dwin_gfx_t *gfx, uint16_t x, uint16_t y,
+		uint16_t color);
+
+/**
+ * @brief 				Start a polyline. Batch must be started with DWIN_GFX_CMD_LINE.
+ * 						Only one polyline can be drawn per batch.
+ */
+dwin_error_t dwin_gfx_polyline_start(dwin_gfx_t *gfx, uint16_t color,
+		uint16_t x, uint16_t y);
+
+/**
+ * @brief 				Extend the polyline started by dwin_gfx_polyline_start().
+ */
+dwin_error_t dwin_gfx_polyline_to(dwin_gfx_t *gfx, uint16_t x, uint16_t y);
+
+/**
+ * @brief 				Append a rectangle. Batch must be started with
+ * 						DWIN_GFX_CMD_RECT or DWIN_GFX_CMD_RECT_FILL.
+ */
+dwin_error_t dwin_gfx_rect(dwin_gfx_t *gfx, uint16_t x0, uint16_t y0,
+		uint16_t x1, uint16_t y1, uint16_t color);
+
+/**
+ * @brief 				Close the batch. Nothing is sent until dwin_gfx_flush() is called.
+ *
+ * @param gfx			dwin_gfx_t handle
+ * @return
+ */
+dwin_error_t dwin_gfx_commit(dwin_gfx_t *gfx);
+
+/**
+ * @brief 				Send the committed batch to the display.
+ * 						The count of the previous block is cleared first, then
+ * 						primitive data goes out in maximal 0x82 frames and the
+ * 						command header is written last, so the display never
+ * 						draws a half updated block.
+ * 						Should be called from the main loop until it stops returning
+ * 						DWIN_ERROR_BUSY.
+ *
+ * @param gfx			dwin_gfx_t handle
+ * @param dwin			dwin_t hanle
+ * @param ctick			current tick value
+ * @return				DWIN_ERROR_BUSY while frames are still pending,
+ * 						DWIN_ERROR_NOERR once every frame went out without a failed write,
+ * 						DWIN_ERROR_TIMEOUT if a write ran out of retries,
+ * 						DWIN_ERROR_ERR if the batch is not committed yet,
+ * 						any other write error after dropping the batch
+ */
+dwin_error_t dwin_gfx_flush(dwin_gfx_t *gfx, dwin_t *dwin, uint32_t ctick);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWIN_STM32_LIB_DWIN_GFX_H_ */
@@ -20,7 +20,20 @@ dwin_error_t dwin_itf_uart_receive_to_idle_dma(dwin_t *dwin) {
 }
 
 dwin_error_t dwin_itf_uart_transmit_dma(dwin_t *dwin, uint16_t tx_len) {
+	/* tx_frame_ptr may point to a constant frame in flash, DMA only reads it */
 	dwin_error_t error = HAL_UART_Transmit_DMA(dwin->huart,
-			dwin->tx_frame_buffer, tx_len);
+			(uint8_t*) dwin->tx_frame_ptr, tx_len);
 	return error;
 }
+
+dwin_error_t dwin_itf_uart_set_baud(dwin_t *dwin, uint32_t baud) {
+	UART_HandleTypeDef *huart = dwin->huart;
+	huart->Init.BaudRate = baud;
+	dwin_error_t error = HAL_UART_Init(huart);
+	return error;
+}
+
+/* Redefine when the API is fed a tick other than HAL_GetTick() */
+__weak uint32_t dwin_itf_get_tick(void) {
+	return HAL_GetTick();
+}
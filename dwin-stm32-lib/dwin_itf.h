@@ -13,5 +13,8 @@
 dwin_error_t dwin_itf_uart_abort(dwin_t *dwin);
 dwin_error_t dwin_itf_uart_receive_to_idle_dma(dwin_t *dwin);
 dwin_error_t dwin_itf_uart_transmit_dma(dwin_t *dwin, uint16_t tx_len);
+dwin_error_t dwin_itf_uart_set_baud(dwin_t *dwin, uint32_t baud);
+/* Current tick at DWIN_TICK_HZ, for frames started from the TX complete ISR */
+uint32_t dwin_itf_get_tick(void);
 
 #endif /* DWIN_STM32_LIB_DWIN_ITF_H_ */
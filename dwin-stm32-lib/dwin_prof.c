@@ -0,0 +1,98 @@
+/*
+ * dwin_prof.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#if !defined(__arm__) && !defined(_POSIX_C_SOURCE)
+/* clock_gettime() and CLOCK_MONOTONIC are POSIX, hidden by -std=c11 */
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "dwin_prof.h"
+
+#if DWIN_USE_PROFILING
+
+#include <stdio.h>
+#include <string.h>
+#if !defined(__arm__)
+#include <time.h>
+#endif
+
+#if DWIN_PROF_HAS_DWT
+#define DWIN_PROF_DEMCR (*(volatile uint32_t*) 0xe000edfcUL)
+#define DWIN_PROF_DEMCR_TRCENA (1UL << 24)
+#define DWIN_PROF_DWT_CTRL (*(volatile uint32_t*) 0xe0001000UL)
+#define DWIN_PROF_DWT_CTRL_CYCCNTENA (1UL << 0)
+#endif
+
+#define DWIN_PROF_LINE_MAX_LEN 96
+
+static const char *const dwin_prof_names[DWIN_PROF_COUNT] = {
+		"dwin_process", "dwin_write_vp build", "dwin_uart_tx_callback",
+		"dwin_uart_rx_callback", };
+
+static dwin_prof_entry_t dwin_prof_table[DWIN_PROF_COUNT];
+
+#if !defined(__arm__)
+uint32_t dwin_prof_host_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t) ((ts.tv_sec * 1000000000ull) + ts.tv_nsec);
+}
+#endif
+
+void dwin_prof_init(void) {
+#if DWIN_PROF_HAS_DWT
+	DWIN_PROF_DEMCR |= DWIN_PROF_DEMCR_TRCENA;
+	DWIN_PROF_DWT_CYCCNT = 0;
+	DWIN_PROF_DWT_CTRL |= DWIN_PROF_DWT_CTRL_CYCCNTENA;
+#endif
+	dwin_prof_reset();
+}
+
+void dwin_prof_record(dwin_prof_id_t id, uint32_t duration) {
+	dwin_prof_entry_t *entry = &dwin_prof_table[id];
+
+	if ((entry->count == 0) || (duration < entry->min)) {
+		entry->min = duration;
+	}
+	if (duration > entry->max) {
+		entry->max = duration;
+	}
+	entry->total += duration;
+	++entry->count;
+}
+
+void dwin_prof_get(dwin_prof_id_t id, dwin_prof_entry_t *entry) {
+	if ((id < DWIN_PROF_COUNT) && (entry != NULL)) {
+		*entry = dwin_prof_table[id];
+	}
+}
+
+void dwin_prof_reset(void) {
+	memset(dwin_prof_table, 0, sizeof(dwin_prof_table));
+}
+
+void dwin_prof_dump(dwin_prof_print_fn_t print) {
+	char line[DWIN_PROF_LINE_MAX_LEN];
+
+	if (print == NULL) {
+		return;
+	}
+
+	for (uint8_t i = 0; i < DWIN_PROF_COUNT; ++i) {
+		dwin_prof_entry_t entry = dwin_prof_table[i];
+		uint32_t mean = entry.count ? (uint32_t) (entry.total / entry.count) : 0;
+
+		snprintf(line, sizeof(line),
+				"%-24s count=%lu min=%lu max=%lu mean=%lu " DWIN_PROF_UNIT,
+				dwin_prof_names[i], (unsigned long) entry.count,
+				(unsigned long) entry.min, (unsigned long) entry.max,
+				(unsigned long) mean);
+		print(line);
+	}
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * dwin_prof.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_PROF_H_
+#define DWIN_STM32_LIB_DWIN_PROF_H_
+
+#include "stdint.h"
+#include "dwin_conf.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Hot path profiling. Define DWIN_USE_PROFILING as 1 to record min / max / mean
+ * durations of the library hot paths. When 0, the hooks compile to nothing.
+ *
+ * Durations are DWT cycle counts on Cortex-M3 / M4 / M7 / M33, and nanoseconds
+ * from clock_gettime(CLOCK_MONOTONIC) when built for a host. Cores without a
+ * DWT cycle counter (Cortex-M0 / M0+ / M23) fall back to dwin_itf_get_tick().
+ */
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) \
+		|| defined(__ARM_ARCH_8M_MAIN__)
+#define DWIN_PROF_HAS_DWT 1
+#else
+#define DWIN_PROF_HAS_DWT 0
+#endif
+
+typedef enum dwin_prof_id_t {
+	DWIN_PROF_PROCESS,
+	DWIN_PROF_WRITE_VP_BUILD,
+	DWIN_PROF_UART_TX_CB,
+	DWIN_PROF_UART_RX_CB,
+	DWIN_PROF_COUNT,
+} dwin_prof_id_t;
+
+typedef struct dwin_prof_entry_t {
+	uint32_t min, max;
+	uint32_t count;
+	uint64_t total;
+} dwin_prof_entry_t;
+
+typedef void (*dwin_prof_print_fn_t)(const char *line);
+
+#if DWIN_USE_PROFILING
+
+#if DWIN_PROF_HAS_DWT
+#define DWIN_PROF_UNIT "cycles"
+#define DWIN_PROF_DWT_CYCCNT (*(volatile uint32_t*) 0xe0001004UL)
+#define DWIN_PROF_NOW() (DWIN_PROF_DWT_CYCCNT)
+#elif defined(__arm__)
+#define DWIN_PROF_UNIT "ticks"
+#define DWIN_PROF_NOW() dwin_itf_get_tick()
+
+uint32_t dwin_itf_get_tick(void);
+#else
+#define DWIN_PROF_UNIT "ns"
+#define DWIN_PROF_NOW() dwin_prof_host_now()
+
+/**
+ * @brief 		Host stub for the cycle counter, clock_gettime(CLOCK_MONOTONIC) in ns.
+ */
+uint32_t dwin_prof_host_now(void);
+#endif
+
+#define DWIN_PROF_BEGIN(id) uint32_t dwin_prof_start_##id = DWIN_PROF_NOW()
+#define DWIN_PROF_END(id) \
+	dwin_prof_record((id), DWIN_PROF_NOW() - dwin_prof_start_##id)
+
+/**
+ * @brief 		Enable the DWT cycle counter, where the core has one, and clear the table.
+ * 				Should be called once on application start.
+ */
+void dwin_prof_init(void);
+
+/**
+ * @brief 				Add one duration sample. Normally only used through DWIN_PROF_END().
+ *
+ * @param id			hot path
+ * @param duration		duration in DWIN_PROF_UNIT
+ */
+void dwin_prof_record(dwin_prof_id_t id, uint32_t duration);
+
+/**
+ * @brief 				Copy one table entry.
+ *
+ * @param id			hot path
+ * @param entry			filled with the entry
+ */
+void dwin_prof_get(dwin_prof_id_t id, dwin_prof_entry_t *entry);
+
+/**
+ * @brief 		Clear the table.
+ */
+void dwin_prof_reset(void);
+
+/**
+ * @brief 				Format the table, one line per hot path.
+ *
+ * @param print			called with every formatted line, e.g. to send it over a debug UART
+ */
+void dwin_prof_dump(dwin_prof_print_fn_t print);
+
+#else
+
+#define DWIN_PROF_BEGIN(id)
+#define DWIN_PROF_END(id) ((void)0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWIN_STM32_LIB_DWIN_PROF_H_ */
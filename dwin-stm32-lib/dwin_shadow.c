@@ -0,0 +1,209 @@
+/*
+ * dwin_shadow.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#include "dwin_shadow.h"
+
+#if DWIN_USE_SHADOW
+
+#include <stddef.h>
+#include <string.h>
+
+/* Most words per replay frame: a whole staging buffer when batching, else a whole tx frame */
+#if DWIN_TX_BATCH_LEN
+#define DWIN_SHADOW_CHUNK_LEN \
+	((((DWIN_TX_BATCH_LEN) - 6) / 2) < DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN ? \
+			(((DWIN_TX_BATCH_LEN) - 6) / 2) : DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN)
+#else
+#define DWIN_SHADOW_CHUNK_LEN DWIN_VP_WRITE_MAX_DATA_LEN
+#endif
+
+static void dwin_shadow_replay_start(dwin_shadow_t *shadow, uint32_t ctick) {
+	shadow->replay_active = 1;
+	shadow->replay_region = 0;
+	shadow->replay_offset = 0;
+	shadow->replay_fail_count = dwin_get_tx_fail_count(shadow->dwin);
+	shadow->replay_start_tick = ctick;
+}
+
+static void dwin_shadow_sentinel_cb(void *ctx, uint8_t *data8_ptr,
+		uint8_t data16_count) {
+	dwin_shadow_t *shadow = (dwin_shadow_t*) ctx;
+
+	if (!shadow->heartbeat_pending || (data16_count == 0)) {
+		return;
+	}
+	shadow->heartbeat_pending = 0;
+
+	if (((data8_ptr[0] << 8) | data8_ptr[1]) != shadow->sentinel_value) {
+		++shadow->panel_resets;
+		dwin_shadow_replay_start(shadow, shadow->heartbeat_tick);
+	}
+}
+
+/*
+ * Sends or stages one write of the replay. Returns DWIN_ERROR_NOERR when it
+ * was taken, so the caller can move on to the next one.
+ */
+static dwin_error_t dwin_shadow_replay_write(dwin_shadow_t *shadow,
+		uint16_t vp_addr, uint16_t *data, uint8_t data_len, uint32_t ctick) {
+#if DWIN_TX_BATCH_LEN
+	(void) ctick;
+	return dwin_batch_write_vp(shadow->dwin, vp_addr, data, data_len);
+#else
+	return dwin_write_vp(shadow->dwin, vp_addr, data, data_len, ctick);
+#endif
+}
+
+static void dwin_shadow_replay_step(dwin_shadow_t *shadow, uint32_t ctick) {
+	while (shadow->replay_region < shadow->region_count) {
+		dwin_shadow_region_t *region = &shadow->regions[shadow->replay_region];
+		uint16_t words = region->len - shadow->replay_offset;
+
+		if (words > DWIN_SHADOW_CHUNK_LEN) {
+			words = DWIN_SHADOW_CHUNK_LEN;
+		}
+		if (dwin_shadow_replay_write(shadow,
+				region->vp_addr + shadow->replay_offset,
+				&region->data[shadow->replay_offset], words, ctick)
+				!= DWIN_ERROR_NOERR) {
+			break;
+		}
+
+		shadow->replay_offset += words;
+		if (shadow->replay_offset == region->len) {
+			++shadow->replay_region;
+			shadow->replay_offset = 0;
+		}
+#if !DWIN_TX_BATCH_LEN
+		/* one write in flight at a time, the next one goes out on a later call */
+		break;
+#endif
+	}
+
+#if DWIN_TX_BATCH_LEN
+	/* start the first staged batch now instead of on the next dwin_process() */
+	dwin_batch_flush(shadow->dwin, ctick);
+#endif
+
+	if ((shadow->replay_region < shadow->region_count)
+			|| !dwin_is_tx_idle(shadow->dwin)) {
+		return;
+	}
+
+	/*
+	 * Every region write is answered by now. The sentinel marks a complete
+	 * replay, so it is only written when none of them failed, otherwise the
+	 * heartbeat would take a partly stale panel as up to date.
+	 */
+	if (dwin_get_tx_fail_count(shadow->dwin) != shadow->replay_fail_count) {
+		++shadow->replay_restarts;
+		dwin_shadow_replay_start(shadow, shadow->replay_start_tick);
+		return;
+	}
+	if (dwin_shadow_replay_write(shadow, shadow->sentinel_vp,
+			&shadow->sentinel_value, 1, ctick) != DWIN_ERROR_NOERR) {
+		return;
+	}
+#if DWIN_TX_BATCH_LEN
+	dwin_batch_flush(shadow->dwin, ctick);
+#endif
+
+	shadow->replay_active = 0;
+	shadow->last_replay_ticks = ctick - shadow->replay_start_tick;
+	shadow->heartbeat_tick = ctick;
+}
+
+dwin_error_t dwin_shadow_init(dwin_shadow_t *shadow, dwin_t *dwin,
+		dwin_shadow_region_t *regions, uint8_t region_count,
+		uint16_t sentinel_vp, uint16_t sentinel_value, uint32_t heartbeat_ticks) {
+	if ((shadow == NULL) || (dwin == NULL)
+			|| ((regions == NULL) && (region_count != 0))
+			|| (sentinel_value == 0) || (DWIN_SHADOW_CHUNK_LEN < 1)) {
+		return DWIN_ERROR_PARAM;
+	}
+	for (uint8_t i = 0; i < region_count; ++i) {
+		if ((regions[i].len == 0) || (regions[i].data == NULL)) {
+			return DWIN_ERROR_PARAM;
+		}
+	}
+
+	shadow->dwin = dwin;
+	shadow->regions = regions;
+	shadow->region_count = region_count;
+	shadow->sentinel_vp = sentinel_vp;
+	shadow->sentinel_value = sentinel_value;
+	shadow->heartbeat_ticks = heartbeat_ticks;
+	shadow->heartbeat_tick = 0;
+	shadow->heartbeat_pending = 0;
+	/* the first heartbeat goes out on the first dwin_shadow_process() call */
+	shadow->heartbeat_due = 1;
+	shadow->replay_active = 0;
+	shadow->replay_restarts = 0;
+	shadow->panel_resets = 0;
+	shadow->missed_heartbeats = 0;
+	shadow->last_replay_ticks = 0;
+
+	return dwin_reg_cb_ctx(dwin, sentinel_vp, dwin_shadow_sentinel_cb, shadow);
+}
+
+dwin_error_t dwin_shadow_process(dwin_shadow_t *shadow, uint32_t ctick) {
+	if (shadow == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (shadow->replay_active) {
+		dwin_shadow_replay_step(shadow, ctick);
+		return DWIN_ERROR_NOERR;
+	}
+
+	if (shadow->heartbeat_pending) {
+		if ((ctick - shadow->heartbeat_tick) < shadow->heartbeat_ticks) {
+			return DWIN_ERROR_NOERR;
+		}
+		/* no reply within a whole interval, the panel may be booting */
+		shadow->heartbeat_pending = 0;
+		++shadow->missed_heartbeats;
+	} else if (!shadow->heartbeat_due
+			&& ((ctick - shadow->heartbeat_tick) < shadow->heartbeat_ticks)) {
+		return DWIN_ERROR_NOERR;
+	}
+
+	dwin_error_t ret_status = dwin_read_vp(shadow->dwin, shadow->sentinel_vp, 1,
+			ctick);
+	if (ret_status == DWIN_ERROR_NOERR) {
+		shadow->heartbeat_tick = ctick;
+		shadow->heartbeat_pending = 1;
+		shadow->heartbeat_due = 0;
+	}
+	return ret_status;
+}
+
+dwin_error_t dwin_shadow_write(dwin_shadow_t *shadow, uint16_t vp_addr,
+		uint16_t *data, uint8_t data_len, uint32_t ctick) {
+	if ((shadow == NULL) || (data == NULL) || (data_len == 0)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	for (uint8_t i = 0; i < shadow->region_count; ++i) {
+		dwin_shadow_region_t *region = &shadow->regions[i];
+
+		if ((vp_addr >= region->vp_addr)
+				&& ((uint32_t) vp_addr + data_len
+						<= (uint32_t) region->vp_addr + region->len)) {
+			memcpy(&region->data[vp_addr - region->vp_addr], data,
+					2 * data_len);
+			return dwin_write_vp(shadow->dwin, vp_addr, data, data_len, ctick);
+		}
+	}
+	return DWIN_ERROR_PARAM;
+}
+
+void dwin_shadow_replay(dwin_shadow_t *shadow, uint32_t ctick) {
+	dwin_shadow_replay_start(shadow, ctick);
+}
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * dwin_shadow.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_SHADOW_H_
+#define DWIN_STM32_LIB_DWIN_SHADOW_H_
+
+#include "dwin.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Panel reset detection and shadow state replay.
+ *
+ * The MCU keeps the last value written to every VP it owns in a set of
+ * shadow regions. A sentinel VP, one not used by the UI, is set to a non
+ * zero value. Every heartbeat_ticks it is read back: a panel that browned out
+ * or rebooted has every VP back at its power-on default, so the sentinel no
+ * longer matches. All regions are then replayed in the largest frames the
+ * link allows, staged back to back with dwin_batch_write_vp() when batching is
+ * compiled in. The sentinel is written last, once every region write landed,
+ * so it marks a complete replay. A replay with a failed write starts over.
+ *
+ * The first heartbeat after start up finds the sentinel unset too, so the
+ * full state is also pushed once the panel answers for the first time.
+ */
+
+/* One contiguous VP span, data holds its last known words */
+typedef struct dwin_shadow_region_t {
+	uint16_t vp_addr;
+	uint16_t len;
+	uint16_t *data;
+} dwin_shadow_region_t;
+
+typedef struct dwin_shadow_t {
+	dwin_t *dwin;
+
+	dwin_shadow_region_t *regions;
+	uint8_t region_count;
+
+	uint16_t sentinel_vp, sentinel_value;
+	uint32_t heartbeat_ticks, heartbeat_tick;
+	uint8_t heartbeat_pending, heartbeat_due;
+
+	uint8_t replay_active;
+	uint8_t replay_region;
+	uint16_t replay_offset, replay_fail_count;
+	uint32_t replay_start_tick;
+
+	/*
+	 * panel restarts detected, heartbeats left unanswered, replays started over
+	 * because a write failed, duration of the last replay
+	 */
+	uint16_t panel_resets, missed_heartbeats, replay_restarts;
+	uint32_t last_replay_ticks;
+} dwin_shadow_t;
+
+#if DWIN_USE_SHADOW
+
+/**
+ * @brief 					Shadow state init function.
+ * 							Registers the sentinel read callback, so should be called after dwin_init().
+ *
+ * @param shadow			dwin_shadow_t handle
+ * @param dwin				dwin_t hanle
+ * @param regions			VP spans to replay, in the order they should be sent
+ * @param region_count		number of regions
+ * @param sentinel_vp		VP not used by the UI, 0 after a panel restart
+ * @param sentinel_value	non zero value kept in the sentinel VP
+ * @param heartbeat_ticks	interval between sentinel reads
+ * @return					DWIN_ERROR_PARAM if sentinel_value is 0 or a region is empty
+ */
+dwin_error_t dwin_shadow_init(dwin_shadow_t *shadow, dwin_t *dwin,
+		dwin_shadow_region_t *regions, uint8_t region_count,
+		uint16_t sentinel_vp, uint16_t sentinel_value, uint32_t heartbeat_ticks);
+
+/**
+ * @brief 			Shadow process function.
+ * 					Should be called from the main loop. Sends the heartbeat reads and
+ * 					stages the next part of a running replay.
+ *
+ * @param shadow	dwin_shadow_t handle
+ * @param ctick		current tick value
+ * @return
+ */
+dwin_error_t dwin_shadow_process(dwin_shadow_t *shadow, uint32_t ctick);
+
+/**
+ * @brief 			Update the shadow copy and write it to the display, see dwin_write_vp().
+ * 					The shadow keeps the value even if the write is rejected.
+ *
+ * @param shadow	dwin_shadow_t handle
+ * @param vp_addr	VP start address, the span has to lie inside one region
+ * @param data		words to write
+ * @param data_len	number of words
+ * @param ctick		current tick value
+ * @return			DWIN_ERROR_PARAM if the span is not covered by a region
+ */
+dwin_error_t dwin_shadow_write(dwin_shadow_t *shadow, uint16_t vp_addr,
+		uint16_t *data, uint8_t data_len, uint32_t ctick);
+
+/**
+ * @brief 			Replay the full shadow state now, as if a panel restart was detected.
+ *
+ * @param shadow	dwin_shadow_t handle
+ * @param ctick		current tick value
+ */
+void dwin_shadow_replay(dwin_shadow_t *shadow, uint32_t ctick);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWIN_STM32_LIB_DWIN_SHADOW_H_ */
@@ -0,0 +1,144 @@
+/*
+ * dwin_startup.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#include "dwin_startup.h"
+
+#if DWIN_USE_STARTUP
+
+#include <stddef.h>
+
+static void dwin_startup_probe_cb(void *ctx, uint8_t *data8_ptr,
+		uint8_t data16_count) {
+	dwin_startup_t *startup = (dwin_startup_t*) ctx;
+	(void) data8_ptr;
+	(void) data16_count;
+
+	/* a late reply to a cancelled probe counts as well, the panel is up */
+	if (startup->state == DWIN_STARTUP_STATE_PROBING) {
+		startup->state = DWIN_STARTUP_STATE_READY;
+	}
+}
+
+static void dwin_startup_probe(dwin_startup_t *startup, uint32_t ctick) {
+	if (startup->probe_pending) {
+		if ((ctick - startup->probe_tick) < startup->probe_ticks) {
+			return;
+		}
+		/* no reply yet, the panel is still booting */
+		if (dwin_tx_cancel(startup->dwin) != DWIN_ERROR_NOERR) {
+			return;
+		}
+		startup->probe_pending = 0;
+	}
+
+	if (dwin_read_vp(startup->dwin, startup->probe_vp, 1, ctick)
+			== DWIN_ERROR_NOERR) {
+		startup->probe_tick = ctick;
+		startup->probe_pending = 1;
+		++startup->probes;
+	}
+}
+
+/* Sends the next table frame, one request in flight at a time */
+static void dwin_startup_push(dwin_startup_t *startup, uint32_t ctick) {
+	if (startup->push_entry < startup->entry_count) {
+		const dwin_startup_entry_t *entry = &startup->table[startup->push_entry];
+		uint16_t words = entry->len - startup->push_offset;
+
+		if (words > DWIN_VP_WRITE_MAX_DATA_LEN) {
+			words = DWIN_VP_WRITE_MAX_DATA_LEN;
+		}
+		if (dwin_write_vp_raw(startup->dwin,
+				entry->vp_addr + startup->push_offset,
+				&entry->data_be[2 * startup->push_offset], words, ctick)
+				!= DWIN_ERROR_NOERR) {
+			return;
+		}
+
+		startup->push_offset += words;
+		if (startup->push_offset == entry->len) {
+			++startup->push_entry;
+			startup->push_offset = 0;
+		}
+		return;
+	}
+
+	/* the last frame is on its way, done once it was ACKed or given up on */
+	if (dwin_is_tx_idle(startup->dwin)) {
+		startup->state = DWIN_STARTUP_STATE_DONE;
+		startup->done_ticks = ctick - startup->start_tick;
+	}
+}
+
+dwin_error_t dwin_startup_init(dwin_startup_t *startup, dwin_t *dwin,
+		const dwin_startup_entry_t *table, uint16_t entry_count,
+		uint16_t probe_vp, uint32_t probe_ticks) {
+	if ((startup == NULL) || (dwin == NULL)
+			|| ((table == NULL) && (entry_count != 0))) {
+		return DWIN_ERROR_PARAM;
+	}
+	for (uint16_t i = 0; i < entry_count; ++i) {
+		if ((table[i].len == 0) || (table[i].data_be == NULL)) {
+			return DWIN_ERROR_PARAM;
+		}
+	}
+
+	startup->dwin = dwin;
+	startup->table = table;
+	startup->entry_count = entry_count;
+	startup->state = DWIN_STARTUP_STATE_PROBING;
+	startup->probe_vp = probe_vp;
+	startup->probe_ticks = probe_ticks;
+	startup->probe_tick = 0;
+	startup->probe_pending = 0;
+	startup->started = 0;
+	startup->push_entry = 0;
+	startup->push_offset = 0;
+	startup->probes = 0;
+	startup->start_tick = 0;
+	startup->ready_ticks = 0;
+	startup->done_ticks = 0;
+
+	return dwin_reg_cb_ctx(dwin, probe_vp, dwin_startup_probe_cb, startup);
+}
+
+dwin_error_t dwin_startup_process(dwin_startup_t *startup, uint32_t ctick) {
+	if (startup == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (!startup->started) {
+		startup->started = 1;
+		startup->start_tick = ctick;
+	}
+
+	switch (startup->state) {
+	case DWIN_STARTUP_STATE_PROBING:
+		dwin_startup_probe(startup, ctick);
+		break;
+	case DWIN_STARTUP_STATE_READY:
+		startup->ready_ticks = ctick - startup->start_tick;
+		startup->probe_pending = 0;
+		startup->state = DWIN_STARTUP_STATE_PUSHING;
+		/* release the answered probe so the first frame goes out right now */
+		dwin_tx_cancel(startup->dwin);
+		dwin_startup_push(startup, ctick);
+		break;
+	case DWIN_STARTUP_STATE_PUSHING:
+		dwin_startup_push(startup, ctick);
+		break;
+	default:
+		break;
+	}
+	return DWIN_ERROR_NOERR;
+}
+
+uint8_t dwin_startup_done(dwin_startup_t *startup) {
+	return startup->state == DWIN_STARTUP_STATE_DONE ? 1 : 0;
+}
+
+#endif
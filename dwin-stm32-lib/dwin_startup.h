@@ -0,0 +1,108 @@
+/*
+ * dwin_startup.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_STARTUP_H_
+#define DWIN_STM32_LIB_DWIN_STARTUP_H_
+
+#include "dwin.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Fast start up: panel ready detection and initial state push.
+ *
+ * Instead of waiting a fixed worst case boot delay, a probe VP is read every
+ * probe_ticks. A probe the booting panel does not answer is dropped with
+ * dwin_tx_cancel() when the next one is due, so the engine RTO and retries
+ * do not stretch the interval. The first reply marks the panel ready and the
+ * initial state table is streamed right after it, one frame of up to
+ * DWIN_VP_WRITE_MAX_DATA_LEN words per request.
+ *
+ * The table data is kept in panel (big endian) byte order so it can live in
+ * flash and is copied into the frames as is, see dwin_write_vp_raw(). The
+ * module owns the link until dwin_startup_done() returns 1.
+ */
+
+/* One contiguous VP span, 2 * len bytes, high byte of each word first */
+typedef struct dwin_startup_entry_t {
+	uint16_t vp_addr;
+	uint16_t len;
+	const uint8_t *data_be;
+} dwin_startup_entry_t;
+
+typedef enum dwin_startup_state_t {
+	DWIN_STARTUP_STATE_PROBING,
+	DWIN_STARTUP_STATE_READY,
+	DWIN_STARTUP_STATE_PUSHING,
+	DWIN_STARTUP_STATE_DONE,
+} dwin_startup_state_t;
+
+typedef struct dwin_startup_t {
+	dwin_t *dwin;
+
+	const dwin_startup_entry_t *table;
+	uint16_t entry_count;
+
+	dwin_startup_state_t state;
+	uint16_t probe_vp;
+	uint32_t probe_ticks, probe_tick;
+	uint8_t probe_pending, started;
+
+	uint16_t push_entry, push_offset;
+
+	/* probes sent, ticks from the first process call to the first reply and to the end of the push */
+	uint16_t probes;
+	uint32_t start_tick, ready_ticks, done_ticks;
+} dwin_startup_t;
+
+#if DWIN_USE_STARTUP
+
+/**
+ * @brief 				Start up init function.
+ * 						Registers the probe read callback, so should be called after dwin_init().
+ *
+ * @param startup		dwin_startup_t handle
+ * @param dwin			dwin_t hanle
+ * @param table			initial state, pushed in order once the panel answers
+ * @param entry_count	number of table entries
+ * @param probe_vp		VP read to detect the panel, e.g. the page register 0x0014
+ * @param probe_ticks	interval between probes, a few reply times of the link
+ * @return				DWIN_ERROR_PARAM if an entry is empty
+ */
+dwin_error_t dwin_startup_init(dwin_startup_t *startup, dwin_t *dwin,
+		const dwin_startup_entry_t *table, uint16_t entry_count,
+		uint16_t probe_vp, uint32_t probe_ticks);
+
+/**
+ * @brief 			Start up process function.
+ * 					Should be called from the main loop, right after dwin_process(),
+ * 					until dwin_startup_done() returns 1.
+ *
+ * @param startup	dwin_startup_t handle
+ * @param ctick		current tick value
+ * @return
+ */
+dwin_error_t dwin_startup_process(dwin_startup_t *startup, uint32_t ctick);
+
+/**
+ * @brief 			Check if the panel answered and the whole table was sent.
+ *
+ * @param startup	dwin_startup_t handle
+ * @return
+ */
+uint8_t dwin_startup_done(dwin_startup_t *startup);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWIN_STM32_LIB_DWIN_STARTUP_H_ */
@@ -0,0 +1,184 @@
+/*
+ * dwin_sys.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#include "dwin_sys.h"
+
+#if DWIN_USE_SYS
+
+#include <stddef.h>
+#include <string.h>
+
+#if DWIN_RX_FRAME_MAX_LEN < DWIN_SYS_SNAPSHOT_RX_FRAME_LEN
+#error DWIN_USE_SYS needs DWIN_RX_FRAME_MAX_LEN of at least DWIN_SYS_SNAPSHOT_RX_FRAME_LEN
+#endif
+
+#define DWIN_SYS_REG_OFFSET(vp_addr) (2 * ((vp_addr) - DWIN_SYS_SNAPSHOT_VP_START))
+
+static const uint8_t dwin_sys_snapshot_frame[] = DWIN_FRAME_READ(
+		DWIN_SYS_SNAPSHOT_VP_START, DWIN_SYS_SNAPSHOT_VP_LEN);
+
+enum dwin_rtc_names {
+	DWIN_RTC_NAME_YEAR,
+	DWIN_RTC_NAME_MONTH,
+	DWIN_RTC_NAME_DAY,
+	DWIN_RTC_NAME_WEEK,
+	DWIN_RTC_NAME_HOUR,
+	DWIN_RTC_NAME_MINUTE,
+	DWIN_RTC_NAME_SECOND,
+};
+
+static void dwin_sys_snapshot_cb(void *ctx, uint8_t *data8_ptr,
+		uint8_t data16_count) {
+	dwin_sys_t *sys = (dwin_sys_t*) ctx;
+
+	sys->request_pending = 0;
+	if (data16_count != DWIN_SYS_SNAPSHOT_VP_LEN) {
+		return;
+	}
+
+	memcpy(sys->regs, data8_ptr, sizeof(sys->regs));
+	sys->snapshot_tick = sys->request_tick;
+	sys->valid = 1;
+}
+
+/* A read in flight answers every query until its reply, failure or timeout */
+static uint8_t dwin_sys_request_pending(dwin_sys_t *sys, uint32_t ctick) {
+	if (sys->request_pending
+			&& ((dwin_get_tx_fail_count(sys->dwin) != sys->request_fail_count)
+					|| ((ctick - sys->request_tick)
+							>= DWIN_SYS_REQUEST_TIMEOUT_TICKS))) {
+		sys->request_pending = 0;
+	}
+	return sys->request_pending;
+}
+
+static dwin_error_t dwin_sys_check_age(dwin_sys_t *sys, uint32_t ctick) {
+	dwin_error_t ret_status = DWIN_ERROR_NOERR;
+
+	if (!sys->valid) {
+		ret_status = DWIN_ERROR_ERR;
+	} else if ((ctick - sys->snapshot_tick) >= sys->max_age_ticks) {
+		ret_status = DWIN_ERROR_TIMEOUT;
+	}
+	if ((ret_status != DWIN_ERROR_NOERR)
+			&& !dwin_sys_request_pending(sys, ctick)) {
+		sys->refresh_requested = 1;
+	}
+	return ret_status;
+}
+
+dwin_error_t dwin_sys_init(dwin_sys_t *sys, dwin_t *dwin,
+		uint32_t max_age_ticks) {
+	if ((sys == NULL) || (dwin == NULL)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	sys->dwin = dwin;
+	sys->max_age_ticks = max_age_ticks;
+	sys->request_tick = 0;
+	sys->snapshot_tick = 0;
+	sys->request_fail_count = 0;
+	sys->valid = 0;
+	sys->refresh_requested = 1;
+	sys->request_pending = 0;
+
+	return dwin_reg_cb_ctx(dwin, DWIN_SYS_SNAPSHOT_VP_START,
+			dwin_sys_snapshot_cb, sys);
+}
+
+dwin_error_t dwin_sys_process(dwin_sys_t *sys, uint32_t ctick) {
+	if (sys == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin_error_t ret_status = DWIN_ERROR_NOERR;
+
+	if (sys->refresh_requested && !dwin_sys_request_pending(sys, ctick)) {
+		uint16_t fail_count = dwin_get_tx_fail_count(sys->dwin);
+		ret_status = dwin_send_frame(sys->dwin, dwin_sys_snapshot_frame,
+				sizeof(dwin_sys_snapshot_frame), ctick);
+		if (ret_status == DWIN_ERROR_NOERR) {
+			sys->request_tick = ctick;
+			sys->request_fail_count = fail_count;
+			sys->refresh_requested = 0;
+			sys->request_pending = 1;
+		}
+	}
+
+	return ret_status;
+}
+
+void dwin_sys_refresh(dwin_sys_t *sys) {
+	sys->refresh_requested = 1;
+}
+
+uint32_t dwin_sys_age(dwin_sys_t *sys, uint32_t ctick) {
+	if ((sys == NULL) || !sys->valid) {
+		return UINT32_MAX;
+	}
+	return ctick - sys->snapshot_tick;
+}
+
+dwin_error_t dwin_sys_get_reg(dwin_sys_t *sys, uint16_t vp_addr,
+		uint16_t *value, uint32_t ctick) {
+	if ((sys == NULL) || (value == NULL)
+			|| (vp_addr < DWIN_SYS_SNAPSHOT_VP_START)
+			|| (vp_addr > DWIN_SYS_SNAPSHOT_VP_END)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin_error_t ret_status = dwin_sys_check_age(sys, ctick);
+
+	if (sys->valid) {
+		uint8_t *reg = &sys->regs[DWIN_SYS_REG_OFFSET(vp_addr)];
+		*value = (reg[0] << 8) | reg[1];
+	}
+	return ret_status;
+}
+
+dwin_error_t dwin_sys_get_rtc(dwin_sys_t *sys, dwin_rtc_t *rtc,
+		uint32_t ctick) {
+	if ((sys == NULL) || (rtc == NULL)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin_error_t ret_status = dwin_sys_check_age(sys, ctick);
+
+	if (sys->valid) {
+		uint8_t *reg = &sys->regs[DWIN_SYS_REG_OFFSET(DWIN_SYS_VP_RTC)];
+		rtc->year = reg[DWIN_RTC_NAME_YEAR];
+		rtc->month = reg[DWIN_RTC_NAME_MONTH];
+		rtc->day = reg[DWIN_RTC_NAME_DAY];
+		rtc->week = reg[DWIN_RTC_NAME_WEEK];
+		rtc->hour = reg[DWIN_RTC_NAME_HOUR];
+		rtc->minute = reg[DWIN_RTC_NAME_MINUTE];
+		rtc->second = reg[DWIN_RTC_NAME_SECOND];
+	}
+	return ret_status;
+}
+
+dwin_error_t dwin_sys_get_page(dwin_sys_t *sys, uint16_t *page,
+		uint32_t ctick) {
+	return dwin_sys_get_reg(sys, DWIN_SYS_VP_PAGE, page, ctick);
+}
+
+dwin_error_t dwin_sys_get_backlight(dwin_sys_t *sys, uint8_t *level,
+		uint32_t ctick) {
+	if (level == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	uint16_t value;
+	dwin_error_t ret_status = dwin_sys_get_reg(sys, DWIN_SYS_VP_BACKLIGHT,
+			&value, ctick);
+	if ((ret_status == DWIN_ERROR_NOERR) || (ret_status == DWIN_ERROR_TIMEOUT)) {
+		*level = value & 0x00ff;
+	}
+	return ret_status;
+}
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * dwin_sys.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_SYS_H_
+#define DWIN_STM32_LIB_DWIN_SYS_H_
+
+#include "dwin.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * DGUS system registers covered by the snapshot:
+ *  0x0010 - 0x0013: RTC (YY MM DD WW HH MM SS --)
+ *  0x0014: current page
+ *  0x0016 - 0x0018: touch panel status
+ *  0x0031: current backlight level (0x00 - 0x64)
+ */
+#define DWIN_SYS_VP_RTC 0x0010
+#define DWIN_SYS_VP_PAGE 0x0014
+#define DWIN_SYS_VP_TOUCH 0x0016
+#define DWIN_SYS_VP_BACKLIGHT 0x0031
+
+#define DWIN_SYS_SNAPSHOT_VP_START DWIN_SYS_VP_RTC
+#define DWIN_SYS_SNAPSHOT_VP_END DWIN_SYS_VP_BACKLIGHT
+#define DWIN_SYS_SNAPSHOT_VP_LEN \
+	(DWIN_SYS_SNAPSHOT_VP_END - DWIN_SYS_SNAPSHOT_VP_START + 1)
+
+/* DWIN_RX_FRAME_MAX_LEN needed to receive the snapshot in one read reply */
+#define DWIN_SYS_SNAPSHOT_RX_FRAME_LEN (7 + (2 * DWIN_SYS_SNAPSHOT_VP_LEN))
+
+/*
+ * A snapshot read is given up after this long without a reply, in case the
+ * reply was lost without the engine counting a failed request.
+ */
+#ifndef DWIN_SYS_REQUEST_TIMEOUT_TICKS
+#define DWIN_SYS_REQUEST_TIMEOUT_TICKS DWIN_TICKS_FROM_MS(1000)
+#endif
+
+typedef struct dwin_rtc_t {
+	uint8_t year, month, day, week;
+	uint8_t hour, minute, second;
+} dwin_rtc_t;
+
+typedef struct dwin_sys_t {
+	dwin_t *dwin;
+
+	uint32_t max_age_ticks;
+	uint32_t request_tick, snapshot_tick;
+	uint16_t request_fail_count;
+	uint8_t valid;
+	volatile uint8_t refresh_requested, request_pending;
+
+	uint8_t regs[2 * DWIN_SYS_SNAPSHOT_VP_LEN];
+} dwin_sys_t;
+
+#if DWIN_USE_SYS
+
+/**
+ * @brief 					System register snapshot init function.
+ * 							Should be called after dwin_init().
+ *
+ * @param sys				dwin_sys_t handle
+ * @param dwin				dwin_t hanle
+ * @param max_age_ticks		snapshot age after which a query triggers a new read
+ * @return
+ */
+dwin_error_t dwin_sys_init(dwin_sys_t *sys, dwin_t *dwin,
+		uint32_t max_age_ticks);
+
+/**
+ * @brief 			Snapshot process function.
+ * 					Should be called from the main loop. Sends one read for any number of
+ * 					queries that found the snapshot stale since the last read, and none
+ * 					while a read is still waiting for its reply.
+ *
+ * @param sys		dwin_sys_t handle
+ * @param ctick		current tick value
+ * @return
+ */
+dwin_error_t dwin_sys_process(dwin_sys_t *sys, uint32_t ctick);
+
+/**
+ * @brief 			Ask for a new snapshot on the next dwin_sys_process() call.
+ *
+ * @param sys		dwin_sys_t handle
+ */
+void dwin_sys_refresh(dwin_sys_t *sys);
+
+/**
+ * @brief 			Snapshot age, measured from the read request.
+ *
+ * @param sys		dwin_sys_t handle
+ * @param ctick		current tick value
+ * @return			UINT32_MAX if no snapshot was received yet
+ */
+uint32_t dwin_sys_age(dwin_sys_t *sys, uint32_t ctick);
+
+/**
+ * @brief 			Read one register from the cached snapshot. Never touches the link.
+ * 					A stale snapshot still returns its value, and a refresh is requested.
+ *
+ * @param sys		dwin_sys_t handle
+ * @param vp_addr	register address, between DWIN_SYS_SNAPSHOT_VP_START and DWIN_SYS_SNAPSHOT_VP_END
+ * @param value		filled with the cached value
+ * @param ctick		current tick value
+ * @return			DWIN_ERROR_TIMEOUT if the value is older than max_age_ticks,
+ * 					DWIN_ERROR_ERR if no snapshot was received yet
+ */
+dwin_error_t dwin_sys_get_reg(dwin_sys_t *sys, uint16_t vp_addr,
+		uint16_t *value, uint32_t ctick);
+
+/**
+ * @brief 			Cached RTC, see dwin_sys_get_reg() for return values.
+ */
+dwin_error_t dwin_sys_get_rtc(dwin_sys_t *sys, dwin_rtc_t *rtc,
+		uint32_t ctick);
+
+/**
+ * @brief 			Cached current page, see dwin_sys_get_reg() for return values.
+ */
+dwin_error_t dwin_sys_get_page(dwin_sys_t *sys, uint16_t *page,
+		uint32_t ctick);
+
+/**
+ * @brief 			Cached backlight level, see dwin_sys_get_reg() for return values.
+ */
+dwin_error_t dwin_sys_get_backlight(dwin_sys_t *sys, uint8_t *level,
+		uint32_t ctick);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWIN_STM32_LIB_DWIN_SYS_H_ */
@@ -0,0 +1,221 @@
+/*
+ * dwin_throttle.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#include "dwin_throttle.h"
+
+#if DWIN_USE_THROTTLE
+
+#include <stddef.h>
+
+static dwin_throttle_vp_t* dwin_throttle_find(dwin_throttle_t *throttle,
+		uint16_t vp_addr) {
+	for (uint8_t i = 0; i < throttle->vp_count; ++i) {
+		if (throttle->vps[i].vp_addr == vp_addr) {
+			return &throttle->vps[i];
+		}
+	}
+	return NULL;
+}
+
+static uint8_t dwin_throttle_in_deadband(dwin_throttle_vp_t *vp,
+		int32_t value) {
+	if (!vp->sent_valid) {
+		return 0;
+	}
+
+	int64_t diff = (int64_t) value - vp->sent_value;
+	int64_t sent = vp->sent_value;
+	uint64_t band = vp->deadband;
+
+	if (diff < 0) {
+		diff = -diff;
+	}
+	if (vp->relative) {
+		band = (uint64_t) (sent < 0 ? -sent : sent) * vp->deadband / 1000;
+	}
+	return ((uint64_t) diff <= band) ? 1 : 0;
+}
+
+static uint8_t dwin_throttle_interval_over(dwin_throttle_vp_t *vp,
+		uint32_t ctick) {
+	return (!vp->sent_valid
+			|| ((ctick - vp->sent_tick) >= vp->min_interval_ticks)) ? 1 : 0;
+}
+
+static dwin_error_t dwin_throttle_send(dwin_throttle_t *throttle,
+		dwin_throttle_vp_t *vp, int32_t value, uint32_t ctick) {
+	uint16_t data[2];
+
+	if (vp->words == 2) {
+		data[0] = (uint16_t) ((uint32_t) value >> 16);
+		data[1] = (uint16_t) ((uint32_t) value & 0xffff);
+	} else {
+		data[0] = (uint16_t) value;
+	}
+
+	dwin_error_t ret_status = dwin_write_vp(throttle->dwin, vp->vp_addr, data,
+			vp->words, ctick);
+	if (ret_status == DWIN_ERROR_NOERR) {
+		/* only on the panel once the write completed, see dwin_throttle_resolve() */
+		throttle->inflight_vp = vp;
+		throttle->inflight_value = value;
+		throttle->inflight_tick = ctick;
+		throttle->inflight_fail_count = dwin_get_tx_fail_count(throttle->dwin);
+		vp->pending = 0;
+	}
+	return ret_status;
+}
+
+static void dwin_throttle_hold(dwin_throttle_vp_t *vp, int32_t value,
+		uint32_t ctick) {
+	if (!vp->pending) {
+		vp->pending = 1;
+		vp->pending_tick = ctick;
+	}
+	vp->pending_value = value;
+}
+
+/*
+ * Settles the write in flight. A request given up on is counted by the
+ * engine, then the value is held again unless a newer one is waiting. Once
+ * the engine is idle without a failure the write was ACKed (or sent, with
+ * ACKs off) and becomes the value on the panel. Returns 1 while it is
+ * still unsettled.
+ */
+static uint8_t dwin_throttle_resolve(dwin_throttle_t *throttle,
+		uint32_t ctick) {
+	dwin_throttle_vp_t *vp = throttle->inflight_vp;
+
+	if (vp == NULL) {
+		return 0;
+	}
+
+	if (dwin_get_tx_fail_count(throttle->dwin)
+			!= throttle->inflight_fail_count) {
+		++throttle->failed;
+		if (!vp->pending) {
+			dwin_throttle_hold(vp, throttle->inflight_value, ctick);
+		}
+	} else if (dwin_is_tx_idle(throttle->dwin)) {
+		vp->sent_value = throttle->inflight_value;
+		vp->sent_tick = throttle->inflight_tick;
+		vp->sent_valid = 1;
+		++throttle->writes;
+	} else {
+		return 1;
+	}
+	throttle->inflight_vp = NULL;
+	return 0;
+}
+
+dwin_error_t dwin_throttle_init(dwin_throttle_t *throttle, dwin_t *dwin,
+		dwin_throttle_vp_t *vps, uint8_t vp_count) {
+	if ((throttle == NULL) || (dwin == NULL)
+			|| ((vps == NULL) && (vp_count != 0))) {
+		return DWIN_ERROR_PARAM;
+	}
+	for (uint8_t i = 0; i < vp_count; ++i) {
+		if (((vps[i].words != 1) && (vps[i].words != 2))
+				|| ((vps[i].deadband != 0) && (vps[i].max_stale_ticks == 0))) {
+			return DWIN_ERROR_PARAM;
+		}
+		vps[i].sent_value = 0;
+		vps[i].pending_value = 0;
+		vps[i].sent_tick = 0;
+		vps[i].pending_tick = 0;
+		vps[i].sent_valid = 0;
+		vps[i].pending = 0;
+		vps[i].suppressed = 0;
+	}
+
+	throttle->dwin = dwin;
+	throttle->vps = vps;
+	throttle->vp_count = vp_count;
+	throttle->next_vp = 0;
+	throttle->inflight_vp = NULL;
+	throttle->writes = 0;
+	throttle->suppressed = 0;
+	throttle->failed = 0;
+
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_throttle_write(dwin_throttle_t *throttle, uint16_t vp_addr,
+		int32_t value, uint32_t ctick) {
+	if (throttle == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin_throttle_vp_t *vp = dwin_throttle_find(throttle, vp_addr);
+	if (vp == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (dwin_throttle_resolve(throttle, ctick)) {
+		/* link busy with our last write, not a suppression */
+		dwin_throttle_hold(vp, value, ctick);
+		return DWIN_ERROR_NOERR;
+	}
+
+	if (vp->sent_valid && (value == vp->sent_value)) {
+		/* already on the panel, drops a held value as well */
+		vp->pending = 0;
+		++vp->suppressed;
+		++throttle->suppressed;
+		return DWIN_ERROR_NOERR;
+	}
+
+	if (dwin_throttle_interval_over(vp, ctick)
+			&& !dwin_throttle_in_deadband(vp, value)) {
+		if (dwin_throttle_send(throttle, vp, value, ctick)
+				!= DWIN_ERROR_NOERR) {
+			/* link busy, not a suppression, retried by dwin_throttle_process() */
+			dwin_throttle_hold(vp, value, ctick);
+		}
+		return DWIN_ERROR_NOERR;
+	}
+
+	dwin_throttle_hold(vp, value, ctick);
+	++vp->suppressed;
+	++throttle->suppressed;
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_throttle_process(dwin_throttle_t *throttle, uint32_t ctick) {
+	if (throttle == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	if (dwin_throttle_resolve(throttle, ctick)) {
+		return DWIN_ERROR_NOERR;
+	}
+
+	/* round robin, so one busy VP does not starve the ones after it */
+	for (uint8_t n = 0; n < throttle->vp_count; ++n) {
+		uint8_t i = (throttle->next_vp + n) % throttle->vp_count;
+		dwin_throttle_vp_t *vp = &throttle->vps[i];
+
+		if (!vp->pending || !dwin_throttle_interval_over(vp, ctick)) {
+			continue;
+		}
+		if (vp->sent_valid && (vp->pending_value == vp->sent_value)) {
+			vp->pending = 0;
+			continue;
+		}
+		if (dwin_throttle_in_deadband(vp, vp->pending_value)
+				&& ((ctick - vp->pending_tick) < vp->max_stale_ticks)) {
+			continue;
+		}
+
+		/* one write in flight at a time, the next one goes out on a later call */
+		throttle->next_vp = (i + 1) % throttle->vp_count;
+		return dwin_throttle_send(throttle, vp, vp->pending_value, ctick);
+	}
+	return DWIN_ERROR_NOERR;
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * dwin_throttle.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_THROTTLE_H_
+#define DWIN_STM32_LIB_DWIN_THROTTLE_H_
+
+#include "dwin.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Deadband and rate limiting for noisy numeric VPs.
+ *
+ * Every throttled VP has a policy in a table. A new value is written only if
+ * it is outside the deadband around the value on the panel and the minimum
+ * interval since the last write has passed. Anything else is held as pending
+ * and counted as suppressed. dwin_throttle_process() sends a pending value
+ * once it leaves the deadband and the interval is over, or at the latest
+ * max_stale_ticks after it was held, so the last value always lands.
+ * A value only counts as on the panel once its write completed, a write the
+ * engine gave up on is held and sent again.
+ *
+ * Values are signed, one word (int16) or two words (int32, high word first).
+ */
+
+typedef struct dwin_throttle_vp_t {
+	/* policy, set up by the application */
+	uint16_t vp_addr;
+	uint8_t words;				/* 1 or 2 */
+	uint8_t relative;			/* deadband in 1/1000 of the value on the panel */
+	uint32_t deadband;			/* changes up to this size are held, 0 sends every change */
+	uint32_t min_interval_ticks;
+	uint32_t max_stale_ticks;	/* longest a held value waits, 0 only with deadband 0 */
+
+	/* state, cleared by dwin_throttle_init() */
+	int32_t sent_value, pending_value;
+	uint32_t sent_tick, pending_tick;
+	uint8_t sent_valid, pending;
+	uint32_t suppressed;
+} dwin_throttle_vp_t;
+
+typedef struct dwin_throttle_t {
+	dwin_t *dwin;
+
+	dwin_throttle_vp_t *vps;
+	uint8_t vp_count, next_vp;
+
+	/* last write handed to the engine, until it was ACKed or given up on */
+	dwin_throttle_vp_t *inflight_vp;
+	int32_t inflight_value;
+	uint32_t inflight_tick;
+	uint16_t inflight_fail_count;
+
+	/* values that landed, writes held back, writes failed and held again, over all VPs */
+	uint32_t writes, suppressed, failed;
+} dwin_throttle_t;
+
+#if DWIN_USE_THROTTLE
+
+/**
+ * @brief 			Throttle init function.
+ *
+ * @param throttle	dwin_throttle_t handle
+ * @param dwin		dwin_t hanle
+ * @param vps		policy table, the state fields are cleared
+ * @param vp_count	number of table entries
+ * @return			DWIN_ERROR_PARAM if a policy is invalid
+ */
+dwin_error_t dwin_throttle_init(dwin_throttle_t *throttle, dwin_t *dwin,
+		dwin_throttle_vp_t *vps, uint8_t vp_count);
+
+/**
+ * @brief 			Write a value through the VP policy, see dwin_write_vp().
+ * 					A value held back or not taken by a busy link is sent later by
+ * 					dwin_throttle_process().
+ *
+ * @param throttle	dwin_throttle_t handle
+ * @param vp_addr	VP address of a table entry
+ * @param value		new value
+ * @param ctick		current tick value
+ * @return			DWIN_ERROR_PARAM if the VP has no table entry
+ */
+dwin_error_t dwin_throttle_write(dwin_throttle_t *throttle, uint16_t vp_addr,
+		int32_t value, uint32_t ctick);
+
+/**
+ * @brief 			Throttle process function.
+ * 					Should be called from the main loop, sends held values that are due.
+ *
+ * @param throttle	dwin_throttle_t handle
+ * @param ctick		current tick value
+ * @return
+ */
+dwin_error_t dwin_throttle_process(dwin_throttle_t *throttle, uint32_t ctick);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWIN_STM32_LIB_DWIN_THROTTLE_H_ */
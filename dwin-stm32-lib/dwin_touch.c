@@ -0,0 +1,212 @@
+/*
+ * dwin_touch.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#include "dwin_touch.h"
+
+#if DWIN_USE_TOUCH
+
+#include <stddef.h>
+
+#if (DWIN_TOUCH_EVENT_QUEUE_LEN & (DWIN_TOUCH_EVENT_QUEUE_LEN - 1)) != 0
+#error DWIN_TOUCH_EVENT_QUEUE_LEN should be a power of 2
+#endif
+#if DWIN_TOUCH_EVENT_QUEUE_LEN > 128
+#error DWIN_TOUCH_EVENT_QUEUE_LEN should not exceed 128
+#endif
+
+#define DWIN_TOUCH_QUEUE_MASK (DWIN_TOUCH_EVENT_QUEUE_LEN - 1)
+
+static const uint8_t dwin_touch_poll_frame[] = DWIN_FRAME_READ(DWIN_TOUCH_VP,
+		DWIN_TOUCH_VP_LEN);
+static const uint8_t dwin_touch_clear_frame[] = DWIN_FRAME_WRITE1(DWIN_TOUCH_VP,
+		0x0000);
+
+#define DWIN_TOUCH_FLAG_UPDATED 0x5a
+
+#define DWIN_TOUCH_STATUS_PRESS 0x01
+#define DWIN_TOUCH_STATUS_RELEASE 0x02
+#define DWIN_TOUCH_STATUS_PRESSING 0x03
+
+enum dwin_touch_data_names {
+	DWIN_TOUCH_DATA_NAME_FLAG,
+	DWIN_TOUCH_DATA_NAME_STATUS,
+	DWIN_TOUCH_DATA_NAME_XPOS_HIGH,
+	DWIN_TOUCH_DATA_NAME_XPOS_LOW,
+	DWIN_TOUCH_DATA_NAME_YPOS_HIGH,
+	DWIN_TOUCH_DATA_NAME_YPOS_LOW,
+};
+
+static uint8_t dwin_touch_queue_empty(dwin_touch_t *touch) {
+	return touch->queue_head == touch->queue_tail ? 1 : 0;
+}
+
+/* Producer side, only called from the dwin_process() / dwin_touch_process() context */
+static void dwin_touch_push(dwin_touch_t *touch, dwin_touch_event_type_t type) {
+	uint8_t head = touch->queue_head;
+
+	if (((head - touch->queue_tail) & 0xff) >= DWIN_TOUCH_EVENT_QUEUE_LEN) {
+		++touch->dropped_events;
+		return;
+	}
+
+	touch->queue[head & DWIN_TOUCH_QUEUE_MASK].type = type;
+	touch->queue[head & DWIN_TOUCH_QUEUE_MASK].xpos = touch->xpos;
+	touch->queue[head & DWIN_TOUCH_QUEUE_MASK].ypos = touch->ypos;
+	DWIN_COMPILER_BARRIER();
+	touch->queue_head = head + 1;
+}
+
+/*
+ * Moves are held back while the consumer still has events to read, so a
+ * slow consumer gets the latest position instead of every intermediate one.
+ */
+static void dwin_touch_flush_move(dwin_touch_t *touch, uint8_t force) {
+	if (touch->move_pending && (force || dwin_touch_queue_empty(touch))) {
+		touch->move_pending = 0;
+		dwin_touch_push(touch, DWIN_TOUCH_EVENT_MOVE);
+	}
+}
+
+/* Back off towards the idle rate, or stop polling */
+static void dwin_touch_idle(dwin_touch_t *touch) {
+	if (touch->idle_poll_ticks == 0) {
+		touch->poll_ticks = 0;
+	} else if (touch->poll_ticks < touch->idle_poll_ticks) {
+		touch->poll_ticks *= 2;
+		if (touch->poll_ticks > touch->idle_poll_ticks) {
+			touch->poll_ticks = touch->idle_poll_ticks;
+		}
+	}
+}
+
+static void dwin_touch_update_cb(void *ctx, uint8_t *data8_ptr,
+		uint8_t data16_count) {
+	dwin_touch_t *touch = (dwin_touch_t*) ctx;
+
+	if (data16_count != DWIN_TOUCH_VP_LEN) {
+		return;
+	}
+
+	if (data8_ptr[DWIN_TOUCH_DATA_NAME_FLAG] != DWIN_TOUCH_FLAG_UPDATED) {
+		/* nothing new since the flag was cleared */
+		if (!touch->pressed) {
+			dwin_touch_idle(touch);
+		}
+		dwin_touch_flush_move(touch, 0);
+		return;
+	}
+
+	/* cleared before the next poll, so the next report is seen as new too */
+	touch->clear_pending = 1;
+
+	uint8_t status = data8_ptr[DWIN_TOUCH_DATA_NAME_STATUS];
+
+	touch->xpos = (data8_ptr[DWIN_TOUCH_DATA_NAME_XPOS_HIGH] << 8)
+			| data8_ptr[DWIN_TOUCH_DATA_NAME_XPOS_LOW];
+	touch->ypos = (data8_ptr[DWIN_TOUCH_DATA_NAME_YPOS_HIGH] << 8)
+			| data8_ptr[DWIN_TOUCH_DATA_NAME_YPOS_LOW];
+
+	if ((status == DWIN_TOUCH_STATUS_PRESS)
+			|| (status == DWIN_TOUCH_STATUS_PRESSING)) {
+		if (!touch->pressed) {
+			touch->pressed = 1;
+			dwin_touch_push(touch, DWIN_TOUCH_EVENT_DOWN);
+		} else {
+			touch->move_pending = 1;
+		}
+		touch->poll_ticks = touch->fast_poll_ticks;
+	} else {
+		if (touch->pressed) {
+			touch->pressed = 0;
+			dwin_touch_flush_move(touch, 1);
+			dwin_touch_push(touch, DWIN_TOUCH_EVENT_UP);
+		} else if (status == DWIN_TOUCH_STATUS_RELEASE) {
+			/* tap that started and ended between two polls */
+			dwin_touch_push(touch, DWIN_TOUCH_EVENT_DOWN);
+			dwin_touch_push(touch, DWIN_TOUCH_EVENT_UP);
+		}
+		dwin_touch_idle(touch);
+	}
+
+	dwin_touch_flush_move(touch, 0);
+}
+
+dwin_error_t dwin_touch_init(dwin_touch_t *touch, dwin_t *dwin,
+		uint32_t fast_poll_ticks, uint32_t idle_poll_ticks) {
+	if ((touch == NULL) || (dwin == NULL) || (fast_poll_ticks == 0)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	touch->dwin = dwin;
+	touch->fast_poll_ticks = fast_poll_ticks;
+	touch->idle_poll_ticks = idle_poll_ticks;
+	touch->poll_ticks = fast_poll_ticks;
+	touch->last_poll_tick = 0;
+	touch->pressed = 0;
+	touch->xpos = 0;
+	touch->ypos = 0;
+	touch->move_pending = 0;
+	touch->clear_pending = 0;
+	touch->queue_head = 0;
+	touch->queue_tail = 0;
+	touch->dropped_events = 0;
+
+	return dwin_reg_cb_ctx(dwin, DWIN_TOUCH_VP, dwin_touch_update_cb, touch);
+}
+
+dwin_error_t dwin_touch_process(dwin_touch_t *touch, uint32_t ctick) {
+	if (touch == NULL) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	dwin_error_t ret_status = DWIN_ERROR_NOERR;
+
+	dwin_touch_flush_move(touch, 0);
+
+	if (touch->clear_pending) {
+		ret_status = dwin_send_frame(touch->dwin, dwin_touch_clear_frame,
+				sizeof(dwin_touch_clear_frame), ctick);
+		if (ret_status == DWIN_ERROR_NOERR) {
+			touch->clear_pending = 0;
+		}
+	} else if ((touch->poll_ticks != 0)
+			&& ((ctick - touch->last_poll_tick) >= touch->poll_ticks)) {
+		ret_status = dwin_send_frame(touch->dwin, dwin_touch_poll_frame,
+				sizeof(dwin_touch_poll_frame), ctick);
+		if (ret_status == DWIN_ERROR_NOERR) {
+			touch->last_poll_tick = ctick;
+		}
+	}
+
+	return ret_status;
+}
+
+void dwin_touch_wake(dwin_touch_t *touch) {
+	touch->poll_ticks = touch->fast_poll_ticks;
+}
+
+dwin_error_t dwin_touch_get_event(dwin_touch_t *touch,
+		dwin_touch_event_t *event) {
+	if ((touch == NULL) || (event == NULL)) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	uint8_t tail = touch->queue_tail;
+
+	if (tail == touch->queue_head) {
+		return DWIN_ERROR_QUEUE;
+	}
+
+	DWIN_COMPILER_BARRIER();
+	*event = touch->queue[tail & DWIN_TOUCH_QUEUE_MASK];
+	DWIN_COMPILER_BARRIER();
+	touch->queue_tail = tail + 1;
+
+	return DWIN_ERROR_NOERR;
+}
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * dwin_touch.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_TOUCH_H_
+#define DWIN_STM32_LIB_DWIN_TOUCH_H_
+
+#include "dwin.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * DGUS touch panel status, 3 words:
+ *  0x0016: 0x5a (updated flag) | status (0x01 press, 0x02 release, 0x03 pressing)
+ *  0x0017: x position
+ *  0x0018: y position
+ *
+ * Only a reply with the updated flag set is decoded. The flag is then
+ * cleared by writing 0 to 0x0016 before the next poll.
+ */
+#define DWIN_TOUCH_VP 0x0016
+#define DWIN_TOUCH_VP_LEN 3
+
+#ifndef DWIN_TOUCH_FAST_POLL_TICKS
+#define DWIN_TOUCH_FAST_POLL_TICKS DWIN_TICKS_FROM_MS(20)
+#endif
+#ifndef DWIN_TOUCH_IDLE_POLL_TICKS
+#define DWIN_TOUCH_IDLE_POLL_TICKS DWIN_TICKS_FROM_MS(320)
+#endif
+
+typedef enum dwin_touch_event_type_t {
+	DWIN_TOUCH_EVENT_DOWN, DWIN_TOUCH_EVENT_MOVE, DWIN_TOUCH_EVENT_UP,
+} dwin_touch_event_type_t;
+
+typedef struct dwin_touch_event_t {
+	dwin_touch_event_type_t type;
+	uint16_t xpos, ypos;
+} dwin_touch_event_t;
+
+typedef struct dwin_touch_t {
+	dwin_t *dwin;
+
+	uint32_t fast_poll_ticks, idle_poll_ticks, poll_ticks;
+	uint32_t last_poll_tick;
+
+	uint8_t pressed;
+	uint16_t xpos, ypos;
+
+	uint8_t move_pending, clear_pending;
+	dwin_touch_event_t move_event;
+
+	dwin_touch_event_t queue[DWIN_TOUCH_EVENT_QUEUE_LEN];
+	volatile uint8_t queue_head, queue_tail;
+	uint16_t dropped_events;
+} dwin_touch_t;
+
+#if DWIN_USE_TOUCH
+
+/**
+ * @brief 					Touch subsystem init function.
+ * 							Registers the 0x0016 read callback, so should be called after dwin_init().
+ *
+ * @param touch				dwin_touch_t handle
+ * @param dwin				dwin_t hanle
+ * @param fast_poll_ticks	poll period while the panel is touched
+ * @param idle_poll_ticks	longest poll period when nobody touches the panel.
+ * 							0 stops polling after release until dwin_touch_wake() is called.
+ * @return
+ */
+dwin_error_t dwin_touch_init(dwin_touch_t *touch, dwin_t *dwin,
+		uint32_t fast_poll_ticks, uint32_t idle_poll_ticks);
+
+/**
+ * @brief 			Touch subsystem process function.
+ * 					Should be called from the main loop, next to dwin_process().
+ *
+ * @param touch		dwin_touch_t handle
+ * @param ctick		current tick value
+ * @return
+ */
+dwin_error_t dwin_touch_process(dwin_touch_t *touch, uint32_t ctick);
+
+/**
+ * @brief 			Switch back to fast polling.
+ * 					Can be called when some other event (e.g. a touch key auto-upload)
+ * 					hints that the panel is being touched.
+ *
+ * @param touch		dwin_touch_t handle
+ */
+void dwin_touch_wake(dwin_touch_t *touch);
+
+/**
+ * @brief 			Take the oldest touch event from the queue.
+ * 					Lock-free, can be called from a different task than dwin_touch_process().
+ *
+ * @param touch		dwin_touch_t handle
+ * @param event		filled with the event
+ * @return			DWIN_ERROR_QUEUE if there is no event
+ */
+dwin_error_t dwin_touch_get_event(dwin_touch_t *touch,
+		dwin_touch_event_t *event);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWIN_STM32_LIB_DWIN_TOUCH_H_ */
@@ -0,0 +1,130 @@
+/*
+ * dwin_trace.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#include "dwin_trace.h"
+
+#if DWIN_USE_TRACE
+
+#include <stddef.h>
+
+enum dwin_trace_record_names {
+	DWIN_TRACE_RECORD_NAME_DIR,
+	DWIN_TRACE_RECORD_NAME_LEN_LOW,
+	DWIN_TRACE_RECORD_NAME_LEN_HIGH,
+	DWIN_TRACE_RECORD_NAME_TICK,
+};
+
+static uint8_t dwin_trace_peek(dwin_trace_t *trace, uint16_t offset) {
+	return trace->buf_ptr[(trace->tail_index + offset) % trace->size];
+}
+
+static void dwin_trace_put(dwin_trace_t *trace, uint8_t data) {
+	trace->buf_ptr[trace->head_index] = data;
+	trace->head_index = (trace->head_index + 1) % trace->size;
+	++trace->used;
+}
+
+static void dwin_trace_drop_oldest(dwin_trace_t *trace) {
+	uint16_t record_len = DWIN_TRACE_RECORD_HEADER_LEN
+			+ (dwin_trace_peek(trace, DWIN_TRACE_RECORD_NAME_LEN_LOW)
+					| (dwin_trace_peek(trace, DWIN_TRACE_RECORD_NAME_LEN_HIGH)
+							<< 8));
+
+	trace->tail_index = (trace->tail_index + record_len) % trace->size;
+	trace->used -= record_len;
+	++trace->dropped_records;
+}
+
+dwin_error_t dwin_trace_init(dwin_trace_t *trace, uint8_t *buf_ptr,
+		uint16_t size) {
+	if ((trace == NULL) || (buf_ptr == NULL)
+			|| (size
+					< (DWIN_TRACE_RECORD_HEADER_LEN + DWIN_TRACE_RECORD_MAX_LEN))) {
+		return DWIN_ERROR_PARAM;
+	}
+
+	trace->buf_ptr = buf_ptr;
+	trace->size = size;
+	dwin_trace_clear(trace);
+
+	return DWIN_ERROR_NOERR;
+}
+
+void dwin_trace_attach(dwin_t *dwin, dwin_trace_t *trace) {
+	dwin->trace = trace;
+}
+
+void dwin_trace_record(dwin_trace_t *trace, dwin_trace_dir_t dir,
+		const uint8_t *data, uint16_t len, uint32_t tick) {
+	uint16_t record_len = DWIN_TRACE_RECORD_HEADER_LEN + len;
+
+	while ((trace->size - trace->used) < record_len) {
+		dwin_trace_drop_oldest(trace);
+	}
+
+	dwin_trace_put(trace, dir);
+	dwin_trace_put(trace, len & 0xff);
+	dwin_trace_put(trace, len >> 8);
+	for (uint8_t i = 0; i < 4; ++i) {
+		dwin_trace_put(trace, (tick >> (8 * i)) & 0xff);
+	}
+	for (uint16_t i = 0; i < len; ++i) {
+		dwin_trace_put(trace, data[i]);
+	}
+}
+
+void dwin_trace_rx_byte(dwin_trace_t *trace, uint8_t data, uint32_t tick) {
+	if (trace->rx_chunk_len == 0) {
+		trace->rx_chunk_tick = tick;
+	}
+	trace->rx_chunk[trace->rx_chunk_len++] = data;
+	if (trace->rx_chunk_len == DWIN_TRACE_RX_CHUNK_MAX_LEN) {
+		dwin_trace_rx_flush(trace);
+	}
+}
+
+void dwin_trace_rx_flush(dwin_trace_t *trace) {
+	if (trace->rx_chunk_len != 0) {
+		dwin_trace_record(trace, DWIN_TRACE_DIR_RX, trace->rx_chunk,
+				trace->rx_chunk_len, trace->rx_chunk_tick);
+		trace->rx_chunk_len = 0;
+	}
+}
+
+void dwin_trace_dump(dwin_trace_t *trace, dwin_trace_write_fn_t write) {
+	if ((trace == NULL) || (write == NULL)) {
+		return;
+	}
+
+	const uint8_t file_header[DWIN_TRACE_FILE_HEADER_LEN] = { 'D', 'W', 'T',
+			'R', DWIN_TRACE_VERSION, 0, 0, 0 };
+	write(file_header, sizeof(file_header));
+
+	if (trace->used == 0) {
+		return;
+	}
+
+	/* the used region wraps at most once */
+	uint16_t first_len = trace->size - trace->tail_index;
+	if (first_len > trace->used) {
+		first_len = trace->used;
+	}
+	write(&trace->buf_ptr[trace->tail_index], first_len);
+	if (first_len < trace->used) {
+		write(trace->buf_ptr, trace->used - first_len);
+	}
+}
+
+void dwin_trace_clear(dwin_trace_t *trace) {
+	trace->head_index = 0;
+	trace->tail_index = 0;
+	trace->used = 0;
+	trace->dropped_records = 0;
+	trace->rx_chunk_len = 0;
+}
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * dwin_trace.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef DWIN_STM32_LIB_DWIN_TRACE_H_
+#define DWIN_STM32_LIB_DWIN_TRACE_H_
+
+#include "dwin.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Binary wire trace. Define DWIN_USE_TRACE as 1 to record every transmitted
+ * frame and every received byte into a caller supplied ring buffer. The
+ * buffer can live in a dedicated RAM section (e.g. a .noinit region) so it
+ * can be read out with a debugger after a fault.
+ *
+ * Dump format (all multi byte fields little endian):
+ *  File header: "DWTR" version(1) reserved(3)
+ *  Record:      direction(1) length(2) tick(4) data(length)
+ *
+ * A TX record holds one DMA transfer, so a write batch is a single record
+ * with its frames back to back. Oldest records are dropped when the buffer
+ * is full.
+ */
+#define DWIN_TRACE_MAGIC "DWTR"
+#define DWIN_TRACE_VERSION 2
+#define DWIN_TRACE_FILE_HEADER_LEN 8
+#define DWIN_TRACE_RECORD_HEADER_LEN 7
+
+/* Longest record: a whole write batch, or the longest frame dwin_send_frame() takes */
+#if DWIN_TX_BATCH_LEN > 258
+#define DWIN_TRACE_RECORD_MAX_LEN DWIN_TX_BATCH_LEN
+#else
+#define DWIN_TRACE_RECORD_MAX_LEN 258
+#endif
+
+/* Received bytes are grouped into records of up to this many bytes */
+#define DWIN_TRACE_RX_CHUNK_MAX_LEN 32
+
+typedef enum dwin_trace_dir_t {
+	DWIN_TRACE_DIR_TX = 0x01, DWIN_TRACE_DIR_RX = 0x02,
+} dwin_trace_dir_t;
+
+typedef void (*dwin_trace_write_fn_t)(const uint8_t *data, uint16_t len);
+
+typedef struct dwin_trace_t {
+	uint8_t *buf_ptr;
+	uint16_t size;
+	uint16_t head_index, tail_index, used;
+	uint32_t dropped_records;
+
+	uint8_t rx_chunk[DWIN_TRACE_RX_CHUNK_MAX_LEN];
+	uint8_t rx_chunk_len;
+	uint32_t rx_chunk_tick;
+} dwin_trace_t;
+
+#if DWIN_USE_TRACE
+
+/**
+ * @brief 			Wire trace init function.
+ *
+ * @param trace		dwin_trace_t handle
+ * @param buf_ptr	trace storage
+ * @param size		trace storage size in bytes, at least
+ * 					DWIN_TRACE_RECORD_HEADER_LEN + DWIN_TRACE_RECORD_MAX_LEN
+ * @return
+ */
+dwin_error_t dwin_trace_init(dwin_trace_t *trace, uint8_t *buf_ptr,
+		uint16_t size);
+
+/**
+ * @brief 			Start recording the traffic of a dwin_t instance.
+ *
+ * @param dwin		dwin_t hanle
+ * @param trace		dwin_trace_t handle, NULL to stop recording
+ */
+void dwin_trace_attach(dwin_t *dwin, dwin_trace_t *trace);
+
+/**
+ * @brief 			Add one record. Normally called by the library only.
+ *
+ * @param trace		dwin_trace_t handle
+ * @param dir		DWIN_TRACE_DIR_TX or DWIN_TRACE_DIR_RX
+ * @param data		record bytes
+ * @param len		record length
+ * @param tick		record timestamp
+ */
+void dwin_trace_record(dwin_trace_t *trace, dwin_trace_dir_t dir,
+		const uint8_t *data, uint16_t len, uint32_t tick);
+
+/**
+ * @brief 			Add one received byte. Normally called by the library only.
+ */
+void dwin_trace_rx_byte(dwin_trace_t *trace, uint8_t data, uint32_t tick);
+
+/**
+ * @brief 			Turn the received bytes collected so far into a record.
+ */
+void dwin_trace_rx_flush(dwin_trace_t *trace);
+
+/**
+ * @brief 			Write out the trace, oldest record first, in the dump format.
+ * 					Can be used to stream it over a debug UART or copy it to RAM.
+ *
+ * @param trace		dwin_trace_t handle
+ * @param write		called with consecutive pieces of the dump
+ */
+void dwin_trace_dump(dwin_trace_t *trace, dwin_trace_write_fn_t write);
+
+/**
+ * @brief 			Drop all records.
+ */
+void dwin_trace_clear(dwin_trace_t *trace);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWIN_STM32_LIB_DWIN_TRACE_H_ */
@@ -9,10 +9,15 @@
 
 #include "main.h"
 #include "dwin.h"
+#include "dwin_touch.h"
+#include "dwin_baud.h"
 #include "defines.h"
 
+/* Link rate negotiated with the display after the 115200 baud start up,
+ * has to divide the 3225600 panel UART clock evenly */
+#define APP_DWIN_BAUD 460800
+
 typedef struct tp_status_t {
-	uint8_t updated;
 	uint8_t status;
 	uint16_t xpos, ypos;
 } tp_status_t;
@@ -27,6 +32,8 @@ typedef struct sys_param_t {
 sys_param_t sys_param;
 extern UART_HandleTypeDef huart3;
 dwin_t dwin;
+dwin_touch_t dwin_touch;
+dwin_baud_t dwin_baud;
 
 static void display_led_button_pressed_cb(uint8_t *data_ptr,
 		uint8_t data16_len) {
@@ -35,32 +42,24 @@ static void display_led_button_pressed_cb(uint8_t *data_ptr,
 	sys_param.led_status_updated = 1;
 }
 
-static void display_touch_update_callback(uint8_t *data_ptr, uint8_t data16_len) {
-	if (data16_len == 0x03) {
-		sys_param.tp_status.updated = data_ptr[0];
-		sys_param.tp_status.status= data_ptr[1];
-		sys_param.tp_status.xpos = (data_ptr[2] << 8) | data_ptr[3];
-		sys_param.tp_status.ypos = (data_ptr[4] << 8) | data_ptr[5];
-	}
-}
-
 void app_init() {
 	dwin_init(&dwin, &huart3, 32);
 	dwin_reg_cb(&dwin, 0x1004, display_led_button_pressed_cb);
-	dwin_reg_cb(&dwin, 0x0016, display_touch_update_callback);
+	dwin_touch_init(&dwin_touch, &dwin, DWIN_TOUCH_FAST_POLL_TICKS,
+	DWIN_TOUCH_IDLE_POLL_TICKS);
+	dwin_baud_init(&dwin_baud, &dwin);
+	dwin_baud_start(&dwin_baud, APP_DWIN_BAUD);
 }
 
 void app_process() {
-	uint32_t prev_tick = HAL_GetTick();
+	dwin_touch_event_t touch_event;
+
 	while (1) {
 		uint32_t ctick = HAL_GetTick();
 
-		if ((ctick - prev_tick) >= 50) {
-			if (dwin_is_tx_idle(&dwin)) {
-				prev_tick = ctick;
-				dwin_read_vp(&dwin, 0x0016, 3, ctick);
-			}
-		} else {
+		if (dwin_baud_process(&dwin_baud, ctick) != DWIN_ERROR_BUSY) {
+			dwin_touch_process(&dwin_touch, ctick);
+
 			if (dwin_is_tx_idle(&dwin)) {
 				sys_param.tick[0] = ctick >> 16;
 				sys_param.tick[1] = ctick;
@@ -68,6 +67,13 @@ void app_process() {
 			}
 		}
 
+		while (dwin_touch_get_event(&dwin_touch, &touch_event)
+				== DWIN_ERROR_NOERR) {
+			sys_param.tp_status.status = touch_event.type;
+			sys_param.tp_status.xpos = touch_event.xpos;
+			sys_param.tp_status.ypos = touch_event.ypos;
+		}
+
 		if (sys_param.led_status_updated == 1) {
 			sys_param.led_status_updated = 0;
 
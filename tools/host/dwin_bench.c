@@ -0,0 +1,371 @@
+/*
+ * dwin_bench.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ *
+ * Benchmarks of the protocol engine against the simulated transport:
+ *  - parser throughput for clean, noisy and fragmented receive streams
+ *  - dwin_write_vp() / dwin_write_vp_raw() frame build cost for 1 - 120
+ *    word writes
+ *  - callback dispatch cost with 8, 64 and 512 registered callbacks
+ *  - VP update rate at several baud rates, with and without write ACKs,
+ *    against a simulated display (simulated time, one tick per microsecond)
+ *
+ * Results are printed as one JSON object.
+ *
+ * Usage: dwin_bench [scale]
+ *  scale multiplies the number of iterations, default 1
+ */
+
+#ifndef _POSIX_C_SOURCE
+/* clock_gettime() and CLOCK_MONOTONIC are POSIX, hidden by -std=c11 */
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "dwin.h"
+#include "dwin_host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if DWIN_TICK_HZ != 1000000
+#error dwin_bench should be built with -DDWIN_TICK_HZ=1000000
+#endif
+#if DWIN_TX_FRAME_MAX_LEN < 246
+#error dwin_bench should be built with -DDWIN_TX_FRAME_MAX_LEN=258
+#endif
+#if DWIN_CALLBACK_ADDR_MAX_COUNT < 512
+#error dwin_bench should be built with -DDWIN_CALLBACK_ADDR_MAX_COUNT=512
+#endif
+
+#define DWIN_BENCH_PARSER_FRAMES 20000
+#define DWIN_BENCH_PARSER_ROUNDS 20
+#define DWIN_BENCH_REPLY_WORDS 4
+#define DWIN_BENCH_REPLY_LEN (7 + (2 * DWIN_BENCH_REPLY_WORDS))
+/* worst case: every frame preceded by up to this many bytes of noise */
+#define DWIN_BENCH_NOISE_MAX_LEN 4
+#define DWIN_BENCH_FRAGMENT_MAX_LEN 3
+#define DWIN_BENCH_STREAM_MAX_LEN \
+	(DWIN_BENCH_PARSER_FRAMES * (DWIN_BENCH_REPLY_LEN + DWIN_BENCH_NOISE_MAX_LEN))
+
+#define DWIN_BENCH_BUILD_WRITES 200000
+#define DWIN_BENCH_DISPATCH_FRAMES 50000
+#define DWIN_BENCH_VP_UPDATE_WORDS 8
+/* Simulated display time from the end of a write to the start of its ACK */
+#define DWIN_BENCH_TURNAROUND_US 100
+#define DWIN_BENCH_SIM_US 1000000
+
+#define DWIN_BENCH_COUNT_OF(array) (sizeof(array) / sizeof((array)[0]))
+
+static const uint8_t dwin_bench_build_words[] = { 1, 2, 4, 8, 16, 32, 64, 120 };
+static const uint16_t dwin_bench_callback_counts[] = { 8, 64, 512 };
+static const uint32_t dwin_bench_bauds[] = { 9600, 115200, 460800, 921600 };
+
+static uint8_t dwin_bench_stream[DWIN_BENCH_STREAM_MAX_LEN];
+static uint32_t dwin_bench_frames;
+static uint32_t dwin_bench_rng = 0x2545f491;
+static uint16_t dwin_bench_tx_len;
+
+/* xorshift32, same sequence on every libc */
+static uint32_t dwin_bench_rand(void) {
+	dwin_bench_rng ^= dwin_bench_rng << 13;
+	dwin_bench_rng ^= dwin_bench_rng >> 17;
+	dwin_bench_rng ^= dwin_bench_rng << 5;
+	return dwin_bench_rng;
+}
+
+static uint64_t dwin_bench_now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000000000ull) + ts.tv_nsec;
+}
+
+static void dwin_bench_setup(dwin_t *dwin) {
+	memset(dwin, 0, sizeof(*dwin));
+	if (dwin_init(dwin, dwin, DWIN_RX_CIRC_BUF_MAX_LEN - 1)
+			!= DWIN_ERROR_NOERR) {
+		fprintf(stderr, "dwin_init failed\n");
+		exit(1);
+	}
+}
+
+static void dwin_bench_teardown(dwin_t *dwin) {
+#if !DWIN_RX_RING_STATIC_LEN
+	free(dwin->rx_ring_buffer.buf_ptr);
+#endif
+}
+
+static uint8_t dwin_bench_upload_cb(uint16_t address, uint8_t *data8_ptr,
+		uint8_t data16_count) {
+	(void) address;
+	(void) data8_ptr;
+	(void) data16_count;
+	++dwin_bench_frames;
+	return 1;
+}
+
+static void dwin_bench_cb(void *ctx, uint8_t *data8_ptr, uint8_t data16_count) {
+	(void) ctx;
+	(void) data8_ptr;
+	(void) data16_count;
+	++dwin_bench_frames;
+}
+
+static void dwin_bench_tx(dwin_t *dwin, const uint8_t *data, uint16_t len) {
+	(void) dwin;
+	(void) data;
+	dwin_bench_tx_len = len;
+}
+
+static uint32_t dwin_bench_put_reply(uint8_t *buf, uint16_t address) {
+	uint32_t len = 0;
+
+	buf[len++] = 0x5a;
+	buf[len++] = 0xa5;
+	buf[len++] = DWIN_BENCH_REPLY_LEN - 3;
+	buf[len++] = 0x83;
+	buf[len++] = address >> 8;
+	buf[len++] = address & 0x00ff;
+	buf[len++] = DWIN_BENCH_REPLY_WORDS;
+	for (uint8_t i = 0; i < (2 * DWIN_BENCH_REPLY_WORDS); ++i) {
+		buf[len++] = dwin_bench_rand();
+	}
+	return len;
+}
+
+/* Noise is random bytes with a high share of false 0x5A headers */
+static uint32_t dwin_bench_build_stream(uint8_t noisy) {
+	uint32_t len = 0;
+
+	for (uint32_t i = 0; i < DWIN_BENCH_PARSER_FRAMES; ++i) {
+		if (noisy) {
+			uint8_t noise_len = dwin_bench_rand()
+					% (DWIN_BENCH_NOISE_MAX_LEN + 1);
+			for (uint8_t j = 0; j < noise_len; ++j) {
+				uint8_t byte = dwin_bench_rand();
+				dwin_bench_stream[len++] = (byte & 0x03) ? 0x5a : byte;
+			}
+		}
+		len += dwin_bench_put_reply(&dwin_bench_stream[len], 0x5000);
+	}
+	return len;
+}
+
+static void dwin_bench_parser(const char *name, uint8_t noisy,
+		uint8_t fragmented, uint32_t rounds) {
+	uint32_t len = dwin_bench_build_stream(noisy);
+	uint64_t elapsed_ns = 0;
+	dwin_t dwin;
+
+	dwin_bench_frames = 0;
+	for (uint32_t round = 0; round < rounds; ++round) {
+		dwin_bench_setup(&dwin);
+		dwin_reg_upload_cb(&dwin, dwin_bench_upload_cb);
+
+		uint64_t start = dwin_bench_now_ns();
+		if (fragmented) {
+			uint32_t pos = 0;
+			while (pos < len) {
+				uint16_t chunk_len = 1
+						+ (dwin_bench_rand() % DWIN_BENCH_FRAGMENT_MAX_LEN);
+				if (chunk_len > (len - pos)) {
+					chunk_len = len - pos;
+				}
+				dwin_host_rx(&dwin, &dwin_bench_stream[pos], chunk_len);
+				dwin_process(&dwin, 0);
+				pos += chunk_len;
+			}
+		} else {
+			dwin_host_rx_process(&dwin, dwin_bench_stream, len, 0);
+		}
+		elapsed_ns += dwin_bench_now_ns() - start;
+
+		dwin_bench_teardown(&dwin);
+	}
+
+	printf("    \"%s\": {\"bytes\": %lu, \"frames\": %lu, \"frames_ok\": %lu, "
+			"\"mb_per_s\": %.3f}", name, (unsigned long) len * rounds,
+			(unsigned long) DWIN_BENCH_PARSER_FRAMES * rounds,
+			(unsigned long) dwin_bench_frames,
+			elapsed_ns ? ((double) len * rounds * 1e3) / elapsed_ns : 0.0);
+}
+
+static void dwin_bench_build(uint32_t scale) {
+	uint16_t words[DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN];
+	uint8_t words_be[2 * DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN];
+	uint32_t writes = DWIN_BENCH_BUILD_WRITES * scale;
+	dwin_t dwin;
+
+	for (uint8_t i = 0; i < DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN; ++i) {
+		words[i] = dwin_bench_rand();
+		words_be[2 * i] = words[i] >> 8;
+		words_be[(2 * i) + 1] = words[i] & 0xff;
+	}
+
+	dwin_bench_setup(&dwin);
+	/* writes complete on TX complete, so only the build and send path is timed */
+	dwin_set_write_ack(&dwin, 0);
+
+	printf("  \"frame_build\": [\n");
+	for (uint8_t i = 0; i < DWIN_BENCH_COUNT_OF(dwin_bench_build_words); ++i) {
+		uint8_t word_count = dwin_bench_build_words[i];
+		uint32_t failed = 0;
+
+		uint64_t start = dwin_bench_now_ns();
+		for (uint32_t j = 0; j < writes; ++j) {
+			if (dwin_write_vp(&dwin, 0x2000, words, word_count, 0)
+					!= DWIN_ERROR_NOERR) {
+				++failed;
+			}
+			dwin_uart_tx_callback(&dwin);
+		}
+		uint64_t elapsed_ns = dwin_bench_now_ns() - start;
+
+		start = dwin_bench_now_ns();
+		for (uint32_t j = 0; j < writes; ++j) {
+			if (dwin_write_vp_raw(&dwin, 0x2000, words_be, word_count, 0)
+					!= DWIN_ERROR_NOERR) {
+				++failed;
+			}
+			dwin_uart_tx_callback(&dwin);
+		}
+		uint64_t raw_elapsed_ns = dwin_bench_now_ns() - start;
+
+		printf("    {\"words\": %u, \"writes\": %lu, \"failed\": %lu, "
+				"\"ns_per_frame\": %.1f, \"raw_ns_per_frame\": %.1f}%s\n",
+				word_count, (unsigned long) writes, (unsigned long) failed,
+				(double) elapsed_ns / writes, (double) raw_elapsed_ns / writes,
+				((i + 1u) < DWIN_BENCH_COUNT_OF(dwin_bench_build_words)) ? "," : "");
+	}
+	printf("  ],\n");
+
+	dwin_bench_teardown(&dwin);
+}
+
+static double dwin_bench_dispatch_run(uint16_t callbacks, uint16_t address,
+		uint32_t frames) {
+	uint8_t frame[DWIN_BENCH_REPLY_LEN];
+	dwin_t dwin;
+
+	dwin_bench_setup(&dwin);
+	for (uint16_t i = 0; i < callbacks; ++i) {
+		dwin_reg_cb_ctx(&dwin, 0x1000 + i, dwin_bench_cb, NULL);
+	}
+	dwin_bench_put_reply(frame, address);
+
+	dwin_bench_frames = 0;
+	uint64_t start = dwin_bench_now_ns();
+	for (uint32_t i = 0; i < frames; ++i) {
+		dwin_host_rx(&dwin, frame, sizeof(frame));
+		dwin_process(&dwin, 0);
+	}
+	uint64_t elapsed_ns = dwin_bench_now_ns() - start;
+
+	dwin_bench_teardown(&dwin);
+	return (dwin_bench_frames == frames) ? (double) elapsed_ns / frames : -1.0;
+}
+
+static void dwin_bench_dispatch(uint32_t scale) {
+	uint32_t frames = DWIN_BENCH_DISPATCH_FRAMES * scale;
+
+	printf("  \"dispatch\": [\n");
+	for (uint8_t i = 0; i < DWIN_BENCH_COUNT_OF(dwin_bench_callback_counts); ++i) {
+		uint16_t callbacks = dwin_bench_callback_counts[i];
+
+		printf("    {\"callbacks\": %u, \"frames\": %lu, "
+				"\"ns_per_frame_first\": %.1f, \"ns_per_frame_last\": %.1f}%s\n",
+				callbacks, (unsigned long) frames,
+				dwin_bench_dispatch_run(callbacks, 0x1000, frames),
+				dwin_bench_dispatch_run(callbacks, 0x1000 + callbacks - 1,
+						frames),
+				((i + 1u) < DWIN_BENCH_COUNT_OF(dwin_bench_callback_counts)) ? "," : "");
+	}
+	printf("  ],\n");
+}
+
+static uint32_t dwin_bench_wire_us(uint32_t baud, uint16_t len) {
+	return ((len * 10ull * 1000000) + baud - 1) / baud;
+}
+
+/*
+ * One simulated second of back to back VP updates. The display answers every
+ * write with an ACK DWIN_BENCH_TURNAROUND_US after it was received.
+ */
+static uint32_t dwin_bench_vp_update_run(uint32_t baud, uint8_t write_ack) {
+	static const uint8_t ack[] = { 0x5a, 0xa5, 0x03, 0x82, 0x4f, 0x4b };
+	uint16_t words[DWIN_BENCH_VP_UPDATE_WORDS] = { 0 };
+	uint32_t now = 0, updates = 0;
+	dwin_t dwin;
+
+	dwin_bench_setup(&dwin);
+	dwin_set_link_baud(&dwin, baud);
+	dwin_set_write_ack(&dwin, write_ack);
+	dwin_host_set_tx_hook(dwin_bench_tx);
+
+	while (now < DWIN_BENCH_SIM_US) {
+		++words[0];
+		if (dwin_write_vp(&dwin, 0x3000, words, DWIN_BENCH_VP_UPDATE_WORDS, now)
+				!= DWIN_ERROR_NOERR) {
+			fprintf(stderr, "vp update rejected\n");
+			exit(1);
+		}
+		now += dwin_bench_wire_us(baud, dwin_bench_tx_len);
+		dwin_uart_tx_callback(&dwin);
+
+		if (write_ack) {
+			now += DWIN_BENCH_TURNAROUND_US
+					+ dwin_bench_wire_us(baud, sizeof(ack));
+			dwin_host_rx(&dwin, ack, sizeof(ack));
+		}
+		dwin_process(&dwin, now);
+		if (dwin_is_tx_idle(&dwin)) {
+			++updates;
+		}
+	}
+
+	dwin_host_set_tx_hook(NULL);
+	dwin_bench_teardown(&dwin);
+	return updates;
+}
+
+static void dwin_bench_vp_update(void) {
+	printf("  \"vp_update\": [\n");
+	for (uint8_t i = 0; i < DWIN_BENCH_COUNT_OF(dwin_bench_bauds); ++i) {
+		uint32_t baud = dwin_bench_bauds[i];
+
+		printf("    {\"baud\": %lu, \"words\": %u, \"turnaround_us\": %u, "
+				"\"ack_updates_per_s\": %lu, \"no_ack_updates_per_s\": %lu}%s\n",
+				(unsigned long) baud, DWIN_BENCH_VP_UPDATE_WORDS,
+				DWIN_BENCH_TURNAROUND_US,
+				(unsigned long) dwin_bench_vp_update_run(baud, 1),
+				(unsigned long) dwin_bench_vp_update_run(baud, 0),
+				((i + 1u) < DWIN_BENCH_COUNT_OF(dwin_bench_bauds)) ? "," : "");
+	}
+	printf("  ]\n");
+}
+
+int main(int argc, char **argv) {
+	long scale = (argc > 1) ? strtol(argv[1], NULL, 0) : 1;
+	if (scale < 1) {
+		fprintf(stderr, "usage: %s [scale]\n", argv[0]);
+		return 1;
+	}
+
+	printf("{\n  \"parser\": {\n");
+	dwin_bench_parser("clean", 0, 0, DWIN_BENCH_PARSER_ROUNDS * scale);
+	printf(",\n");
+	dwin_bench_parser("noisy", 1, 0, DWIN_BENCH_PARSER_ROUNDS * scale);
+	printf(",\n");
+	dwin_bench_parser("fragmented", 0, 1, DWIN_BENCH_PARSER_ROUNDS * scale);
+	printf("\n  },\n");
+
+	dwin_bench_build(scale);
+	dwin_bench_dispatch(scale);
+	dwin_bench_vp_update();
+	printf("}\n");
+
+	return 0;
+}
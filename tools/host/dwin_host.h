@@ -0,0 +1,51 @@
+/*
+ * dwin_host.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#ifndef TOOLS_HOST_DWIN_HOST_H_
+#define TOOLS_HOST_DWIN_HOST_H_
+
+#include "dwin.h"
+
+/*
+ * Simulated transport for running the library on a Linux host.
+ * Replaces dwin_itf.c: transmitted frames are handed to an optional hook and
+ * received bytes are written into the RX ring the same way the UART DMA does.
+ */
+
+typedef void (*dwin_host_tx_fn_t)(dwin_t *dwin, const uint8_t *data,
+		uint16_t len);
+
+/**
+ * @brief 			Hook called for every frame the library transmits.
+ *
+ * @param tx_fn		hook, NULL to drop transmitted frames
+ */
+void dwin_host_set_tx_hook(dwin_host_tx_fn_t tx_fn);
+
+/**
+ * @brief 			Write received bytes into the RX ring and report them like an idle line event.
+ * 					len must stay below half of the ring size, see dwin_host_rx_process().
+ *
+ * @param dwin		dwin_t hanle
+ * @param data		received bytes
+ * @param len		number of bytes
+ */
+void dwin_host_rx(dwin_t *dwin, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 			Feed any number of received bytes, calling dwin_process() after
+ * 					every half ring, as the DMA half / full transfer events would.
+ *
+ * @param dwin		dwin_t hanle
+ * @param data		received bytes
+ * @param len		number of bytes
+ * @param ctick		tick passed to dwin_process()
+ */
+void dwin_host_rx_process(dwin_t *dwin, const uint8_t *data, uint32_t len,
+		uint32_t ctick);
+
+#endif /* TOOLS_HOST_DWIN_HOST_H_ */
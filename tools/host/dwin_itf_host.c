@@ -0,0 +1,74 @@
+/*
+ * dwin_itf_host.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ */
+
+#include "dwin_itf.h"
+#include "dwin_host.h"
+#include <stddef.h>
+
+static dwin_host_tx_fn_t dwin_host_tx_fn;
+static uint16_t dwin_host_rx_pos;
+static uint32_t dwin_host_tick;
+
+void dwin_host_set_tx_hook(dwin_host_tx_fn_t tx_fn) {
+	dwin_host_tx_fn = tx_fn;
+}
+
+void dwin_host_rx(dwin_t *dwin, const uint8_t *data, uint16_t len) {
+	if (len == 0) {
+		return;
+	}
+	for (uint16_t i = 0; i < len; ++i) {
+		dwin->rx_ring_buffer.buf_ptr[dwin_host_rx_pos] = data[i];
+		dwin_host_rx_pos = (dwin_host_rx_pos + 1) % dwin->rx_ring_buffer.size;
+	}
+	dwin_uart_rx_callback(dwin,
+			(dwin_host_rx_pos + dwin->rx_ring_buffer.size - 1)
+					% dwin->rx_ring_buffer.size);
+}
+
+void dwin_host_rx_process(dwin_t *dwin, const uint8_t *data, uint32_t len,
+		uint32_t ctick) {
+	uint16_t chunk_max_len = dwin->rx_ring_buffer.size / 2;
+
+	dwin_host_tick = ctick;
+	while (len != 0) {
+		uint16_t chunk_len = len > chunk_max_len ? chunk_max_len : len;
+		dwin_host_rx(dwin, data, chunk_len);
+		dwin_process(dwin, ctick);
+		data += chunk_len;
+		len -= chunk_len;
+	}
+}
+
+dwin_error_t dwin_itf_uart_abort(dwin_t *dwin) {
+	(void) dwin;
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_itf_uart_receive_to_idle_dma(dwin_t *dwin) {
+	(void) dwin;
+	dwin_host_rx_pos = 0;
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_itf_uart_transmit_dma(dwin_t *dwin, uint16_t tx_len) {
+	if (dwin_host_tx_fn != NULL) {
+		dwin_host_tx_fn(dwin, dwin->tx_frame_ptr, tx_len);
+	}
+	return DWIN_ERROR_NOERR;
+}
+
+dwin_error_t dwin_itf_uart_set_baud(dwin_t *dwin, uint32_t baud) {
+	(void) dwin;
+	(void) baud;
+	return DWIN_ERROR_NOERR;
+}
+
+uint32_t dwin_itf_get_tick(void) {
+	/* the last tick passed to dwin_host_rx_process() */
+	return dwin_host_tick;
+}
@@ -0,0 +1,244 @@
+/*
+ * dwin_replay.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Alex Antony
+ *
+ * Feeds a wire trace captured with dwin_trace_dump() back through the
+ * dwin_process() parser as fast as possible.
+ *
+ * Transmitted frames are replayed through dwin_write_vp() / dwin_read_vp() so
+ * that ACK and read reply matching behave as on the target, received bytes go
+ * through the simulated RX ring. Record ticks are used as the current tick.
+ *
+ * Usage: dwin_replay <trace file> [iterations]
+ */
+
+#ifndef _POSIX_C_SOURCE
+/* clock_gettime() and CLOCK_MONOTONIC are POSIX, hidden by -std=c11 */
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "dwin.h"
+#include "dwin_trace.h"
+#include "dwin_host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !DWIN_USE_STATS
+#error dwin_replay should be built with -DDWIN_USE_STATS=1
+#endif
+
+#define DWIN_REPLAY_FUNC_CODE_OFFSET 3
+#define DWIN_REPLAY_DATA_OFFSET 4
+
+typedef struct dwin_replay_result_t {
+	uint32_t records, tx_rejected, uploads;
+} dwin_replay_result_t;
+
+static dwin_replay_result_t result;
+
+static uint8_t dwin_replay_upload_cb(uint16_t address, uint8_t *data8_ptr,
+		uint8_t data16_count) {
+	(void) address;
+	(void) data8_ptr;
+	(void) data16_count;
+	++result.uploads;
+	return 1;
+}
+
+/* Decodes the data words of a 0x82 write frame, returns their count */
+static uint8_t dwin_replay_write_words(const uint8_t *frame, uint16_t len,
+		uint16_t *words) {
+	uint8_t word_count = (len - DWIN_REPLAY_DATA_OFFSET - 2) / 2;
+
+	for (uint8_t i = 0; i < word_count; ++i) {
+		const uint8_t *word = &frame[DWIN_REPLAY_DATA_OFFSET + 2 + (2 * i)];
+		words[i] = (word[0] << 8) | word[1];
+	}
+	return word_count;
+}
+
+static dwin_error_t dwin_replay_frame(dwin_t *dwin, const uint8_t *frame,
+		uint16_t len, uint32_t tick) {
+	uint16_t words[DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN];
+	uint16_t address = (frame[DWIN_REPLAY_DATA_OFFSET] << 8)
+			| frame[DWIN_REPLAY_DATA_OFFSET + 1];
+
+	if (frame[DWIN_REPLAY_FUNC_CODE_OFFSET] == 0x82) {
+		uint8_t word_count = dwin_replay_write_words(frame, len, words);
+		return dwin_write_vp(dwin, address, words, word_count, tick);
+	} else if ((frame[DWIN_REPLAY_FUNC_CODE_OFFSET] == 0x83)
+			&& (len > (DWIN_REPLAY_DATA_OFFSET + 2))) {
+		return dwin_read_vp(dwin, address, frame[DWIN_REPLAY_DATA_OFFSET + 2],
+				tick);
+	}
+	return DWIN_ERROR_PARAM;
+}
+
+#if DWIN_TX_BATCH_LEN
+/* Stages the writes of a batch record and sends them as one transfer */
+static dwin_error_t dwin_replay_batch(dwin_t *dwin, const uint8_t *data,
+		uint16_t len, uint32_t tick) {
+	uint16_t words[DWIN_VP_WRITE_PROTOCOL_MAX_DATA_LEN];
+
+	for (uint16_t pos = 0; pos < len; pos += 3 + data[pos + 2]) {
+		const uint8_t *frame = &data[pos];
+		uint16_t frame_len = 3 + frame[2];
+
+		if (frame[DWIN_REPLAY_FUNC_CODE_OFFSET] != 0x82) {
+			return DWIN_ERROR_PARAM;
+		}
+		uint8_t word_count = dwin_replay_write_words(frame, frame_len, words);
+		dwin_error_t error = dwin_batch_write_vp(dwin,
+				(frame[DWIN_REPLAY_DATA_OFFSET] << 8)
+						| frame[DWIN_REPLAY_DATA_OFFSET + 1], words,
+				word_count);
+		if (error != DWIN_ERROR_NOERR) {
+			return error;
+		}
+	}
+	return dwin_batch_flush(dwin, tick);
+}
+#endif
+
+/*
+ * A TX record holds one transfer: a single frame, or a write batch with its
+ * frames back to back. Each frame is walked by its own length byte.
+ */
+static void dwin_replay_tx(dwin_t *dwin, const uint8_t *data, uint16_t len,
+		uint32_t tick) {
+	dwin_error_t error = DWIN_ERROR_PARAM;
+	uint16_t frame_count = 0;
+	uint16_t pos = 0;
+
+	while ((pos + DWIN_REPLAY_DATA_OFFSET + 2) <= len) {
+		uint16_t frame_len = 3 + data[pos + 2];
+		if ((frame_len < (DWIN_REPLAY_DATA_OFFSET + 2))
+				|| ((pos + frame_len) > len)) {
+			break;
+		}
+		pos += frame_len;
+		++frame_count;
+	}
+
+	if ((frame_count == 0) || (pos != len)) {
+		error = DWIN_ERROR_PARAM;
+	} else if (frame_count == 1) {
+		error = dwin_replay_frame(dwin, data, len, tick);
+	} else {
+#if DWIN_TX_BATCH_LEN
+		error = dwin_replay_batch(dwin, data, len, tick);
+#endif
+	}
+
+	if (error == DWIN_ERROR_NOERR) {
+		dwin_uart_tx_callback(dwin);
+	} else {
+		++result.tx_rejected;
+	}
+}
+
+static int dwin_replay_run(dwin_t *dwin, const uint8_t *trace, long trace_len) {
+	long pos = DWIN_TRACE_FILE_HEADER_LEN;
+
+	while ((pos + DWIN_TRACE_RECORD_HEADER_LEN) <= trace_len) {
+		uint8_t dir = trace[pos];
+		uint16_t len = trace[pos + 1] | (trace[pos + 2] << 8);
+		uint32_t tick = trace[pos + 3] | (trace[pos + 4] << 8)
+				| (trace[pos + 5] << 16) | ((uint32_t) trace[pos + 6] << 24);
+		const uint8_t *data = &trace[pos + DWIN_TRACE_RECORD_HEADER_LEN];
+
+		pos += DWIN_TRACE_RECORD_HEADER_LEN + len;
+		if (pos > trace_len) {
+			fprintf(stderr, "truncated record\n");
+			return -1;
+		}
+
+		dwin_process(dwin, tick);
+		if (dir == DWIN_TRACE_DIR_TX) {
+			dwin_replay_tx(dwin, data, len, tick);
+		} else {
+			dwin_host_rx_process(dwin, data, len, tick);
+		}
+		++result.records;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <trace file> [iterations]\n", argv[0]);
+		return 1;
+	}
+	long iterations = (argc > 2) ? strtol(argv[2], NULL, 0) : 1;
+
+	FILE *file = fopen(argv[1], "rb");
+	if (file == NULL) {
+		perror(argv[1]);
+		return 1;
+	}
+	fseek(file, 0, SEEK_END);
+	long trace_len = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	uint8_t *trace = malloc(trace_len);
+	if ((trace == NULL)
+			|| (fread(trace, 1, trace_len, file) != (size_t) trace_len)) {
+		fprintf(stderr, "failed to read %s\n", argv[1]);
+		return 1;
+	}
+	fclose(file);
+
+	if ((trace_len < DWIN_TRACE_FILE_HEADER_LEN)
+			|| (memcmp(trace, DWIN_TRACE_MAGIC, 4) != 0)
+			|| (trace[4] != DWIN_TRACE_VERSION)) {
+		fprintf(stderr, "%s is not a version %d dwin trace\n", argv[1],
+		DWIN_TRACE_VERSION);
+		return 1;
+	}
+
+	dwin_t dwin;
+	uint64_t rx_bytes_total = 0;
+	struct timespec start, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (long i = 0; i < iterations; ++i) {
+		/* every pass replays the same capture, the counts are per pass */
+		memset(&result, 0, sizeof(result));
+		memset(&dwin, 0, sizeof(dwin));
+		if (dwin_init(&dwin, &dwin, DWIN_RX_CIRC_BUF_MAX_LEN - 1)
+				!= DWIN_ERROR_NOERR) {
+			fprintf(stderr, "dwin_init failed\n");
+			return 1;
+		}
+		dwin_reg_upload_cb(&dwin, dwin_replay_upload_cb);
+		if (dwin_replay_run(&dwin, trace, trace_len) != 0) {
+			return 1;
+		}
+		rx_bytes_total += dwin_get_stats(&dwin)->rx_bytes;
+#if !DWIN_RX_RING_STATIC_LEN
+		free(dwin.rx_ring_buffer.buf_ptr);
+#endif
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	double elapsed_s = (end.tv_sec - start.tv_sec)
+			+ ((end.tv_nsec - start.tv_nsec) / 1e9);
+
+	printf("{\"records\": %lu, \"iterations\": %ld, \"rx_bytes\": %llu, "
+			"\"rx_frames\": %llu, \"resyncs\": %llu, \"uploads\": %lu, "
+			"\"tx_rejected\": %lu, \"elapsed_s\": %.6f, \"rx_mb_per_s\": %.3f}\n",
+			(unsigned long) result.records, iterations,
+			(unsigned long long) dwin_get_stats(&dwin)->rx_bytes,
+			(unsigned long long) dwin_get_stats(&dwin)->rx_frames,
+			(unsigned long long) dwin_get_stats(&dwin)->resyncs,
+			(unsigned long) result.uploads, (unsigned long) result.tx_rejected,
+			elapsed_s,
+			elapsed_s > 0 ? (rx_bytes_total / elapsed_s) / 1e6 : 0.0);
+
+	free(trace);
+	return 0;
+}
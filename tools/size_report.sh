@@ -0,0 +1,51 @@
+#!/bin/sh
+#
+# size_report.sh
+#
+# Prints the flash (text + data) and RAM (data + bss, plus one dwin_t) cost of
+# the library for every DWIN_CONF_PROFILE in dwin_conf.h. dwin_itf.c is left
+# out since it depends on the STM32 HAL.
+#
+# usage: tools/size_report.sh [extra cflags]
+#
+# The toolchain and flags can be overridden from the environment, e.g. to run
+# it with the host compiler: CC=gcc SIZE=size NM=nm CFLAGS=-Os tools/size_report.sh
+#
+
+set -e
+
+CC=${CC:-arm-none-eabi-gcc}
+SIZE=${SIZE:-arm-none-eabi-size}
+NM=${NM:-arm-none-eabi-nm}
+CFLAGS=${CFLAGS:-"-mcpu=cortex-m4 -mthumb -Os -ffunction-sections -fdata-sections"}
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+LIB="$ROOT/dwin-stm32-lib"
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+cat > "$OUT/dwin_size_probe.c" << 'EOF'
+#include "dwin.h"
+dwin_t dwin_size_probe;
+EOF
+
+for profile in MINIMAL STANDARD HIGH_THROUGHPUT; do
+	mkdir -p "$OUT/$profile"
+	for src in "$LIB"/*.c; do
+		case "$src" in
+		*/dwin_itf.c) continue ;;
+		esac
+		$CC $CFLAGS -DDWIN_CONF_PROFILE=DWIN_CONF_PROFILE_$profile "$@" \
+			-I"$LIB" -c "$src" -o "$OUT/$profile/$(basename "$src" .c).o"
+	done
+	$CC $CFLAGS -DDWIN_CONF_PROFILE=DWIN_CONF_PROFILE_$profile "$@" \
+		-I"$LIB" -c "$OUT/dwin_size_probe.c" -o "$OUT/dwin_size_probe.o"
+	dwin_t_size=$(printf '%d' "0x$($NM -S "$OUT/dwin_size_probe.o" \
+		| awk '$4 == "dwin_size_probe" { print $2 }')")
+
+	echo "== $profile"
+	$SIZE -t "$OUT/$profile"/*.o | sed "s|$OUT/$profile/||"
+	$SIZE -t "$OUT/$profile"/*.o | awk -v obj="$dwin_t_size" '
+		END { printf "flash: %d bytes, static RAM: %d bytes, dwin_t: %d bytes\n\n",
+			$1 + $2, $2 + $3, obj }'
+done